@@ -0,0 +1,55 @@
+// board.h
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <glad/glad.h>
+#include "grid.h"
+
+/* Tile-texture board renderer.
+   The level is baked into an R8UI texture laid over the pellet lattice, sub x
+   sub texels per lattice cell: BOARD_WALL marks texels whose centre lies in a
+   wall, BOARD_PELLET on a cell's centre texel marks a live pellet. One
+   fullscreen pass (shaders/board.*) then draws every wall and pellet on
+   screen, so its cost follows the pixel count, not the pellet count, and
+   eating a pellet rewrites one texel. Walls snap to the texel grid; pellets
+   keep the world shader's exact circle. */
+#define BOARD_WALL   1u
+#define BOARD_PELLET 2u
+#define BOARD_SUB    4      // texels per lattice cell and axis, halved if the texture gets too big
+
+typedef struct {
+    GLuint program;
+    GLuint tex;
+    GLint loc_uViewport;
+    GLint loc_uCamera;
+    GLint loc_uLattice;
+    GLint loc_uPelletHalf;
+    GLint loc_uBoard;
+
+    float origin_x, origin_y;  // world corner of texel (0, 0), a lattice point
+    float spacing;             // lattice cell edge
+    int sub;                   // texels per lattice cell and axis
+    int width, height;         // texels
+    float pellet_hx, pellet_hy;
+    unsigned char *texels;     // CPU copy of the texture
+} Board;
+
+int  board_init(Board *b, GLuint program);
+void board_shutdown(Board *b);
+// Lays the board over the lattice through (lattice_x, lattice_y) with cell
+// spacing, large enough for the level box plus a cell on every side, and
+// rasterizes the walls' visible boxes. Pellets start absent; mark them with
+// board_set_pellet, then board_upload.
+int  board_build(Board *b, float min_x, float min_y, float max_x, float max_y,
+                 float lattice_x, float lattice_y, float spacing,
+                 const GridItem *walls, int wall_count, float pellet_hx, float pellet_hy);
+// CPU copy only: pellet of the lattice cell holding (x, y)
+void board_set_pellet(Board *b, float x, float y, int alive);
+void board_upload(Board *b);
+// clears the pellet and uploads just its texel
+void board_eat_pellet(Board *b, float x, float y);
+// one fullscreen quad over the current viewport; quad_vao is the unit quad
+void board_draw(Board *b, GLuint quad_vao, float cam_x, float cam_y,
+                float view_hx, float view_hy, int fb_width, int fb_height);
+
+#endif // BOARD_H
@@ -0,0 +1,63 @@
+// capture.h
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <glad/glad.h>
+#include <pthread.h>
+#include <stdio.h>
+
+/* Asynchronous frame capture to a Y4M file.
+   capture_frame queues a glReadPixels into one of CAPTURE_PBOS pixel buffers
+   and hands older readbacks whose fence has signalled to a writer thread,
+   which converts them to YUV 4:4:4 and writes them out. With
+   GL_ARB_buffer_storage the PBOs stay persistently mapped and the writer
+   reads them in place; otherwise the GL thread maps each one and copies it
+   into a queue slot. When the writer falls behind frames are dropped, never
+   waited for. */
+#define CAPTURE_PBOS 4
+#define CAPTURE_QUEUE 8
+
+typedef struct {
+    unsigned long long frames;     // capture_frame calls
+    unsigned long long written;    // frames that reached the file (writer thread, under lock)
+    unsigned long long dropped;    // no free buffer, or framebuffer size mismatch
+    double main_seconds;           // time spent in capture_frame on the GL thread
+} CaptureStats;
+
+enum { CAPTURE_PBO_FREE, CAPTURE_PBO_READING, CAPTURE_PBO_WRITING };
+
+typedef struct {
+    int width, height;
+    size_t frame_bytes;            // width * height * 4, RGBA bottom-up as GL returns it
+    FILE *file;
+    int persistent;                // 1 = writer reads mapped PBOs, 0 = copies via slots
+
+    GLuint pbos[CAPTURE_PBOS];
+    GLsync fences[CAPTURE_PBOS];
+    unsigned char *mapped[CAPTURE_PBOS];
+    int pbo_state[CAPTURE_PBOS];   // CAPTURE_PBO_*; WRITING -> FREE happens on the writer
+    int next;                      // PBO the next readback goes into
+    int in_flight;                 // READING PBOs, the oldest is next - in_flight
+
+    // writer queue; an entry is a PBO index (persistent) or a slot index (copy)
+    unsigned char *slots[CAPTURE_QUEUE];
+    int free_slots[CAPTURE_QUEUE];
+    int free_count;
+    int queue[CAPTURE_QUEUE];
+    int head, count;
+    int quit;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_t writer;
+
+    CaptureStats stats;
+} Capture;
+
+// opens path and writes the stream header; needs a current GL context
+int  capture_open(Capture *c, const char *path, int width, int height, int fps);
+// call after rendering and before the swap, with the frame's framebuffer bound for reading
+void capture_frame(Capture *c, int fb_width, int fb_height);
+// flushes the frames still in flight, joins the writer and closes the file
+void capture_close(Capture *c);
+
+#endif // CAPTURE_H
@@ -0,0 +1,65 @@
+// cmdlist.h
+#ifndef CMDLIST_H
+#define CMDLIST_H
+
+#include <glad/glad.h>
+#include <stdint.h>
+
+/* Render command list.
+   Game code appends compact draw commands during the frame; cmdlist_submit
+   radix-sorts them by a state key (layer, program, VAO, texture, tint),
+   merges neighbours that draw adjacent instance ranges with identical state,
+   and replays the result binding only what actually changes. */
+
+// per-instance attribute layout of a VAO, so a command can draw any
+// instance range [first, first + count) without glDrawElementsInstancedBaseInstance
+#define CMD_MAX_INSTANCE_ATTRIBS 4
+typedef struct {
+    GLuint buffer;
+    GLsizei stride;
+    int attrib_count;
+    struct { GLuint index; GLint size; GLuint offset; } attribs[CMD_MAX_INSTANCE_ATTRIBS];
+    int bound_first;   // instance the attributes currently point at (managed by cmdlist)
+} CmdInstanceLayout;
+
+typedef struct {
+    uint64_t key;                      // built by cmdlist_push, sort order
+    GLuint program;
+    GLuint vao;
+    GLuint texture;                    // 0 = leave unit 0 alone
+    GLenum texture_target;
+    float tint[3];                     // uploaded to tint_loc when it changes
+    GLint tint_loc;                    // -1 = program has no tint uniform
+    GLint base_loc;                    // receives first_instance, -1 = none
+    CmdInstanceLayout *layout;         // NULL = draw from instance 0
+    GLsizei index_count;               // GL_TRIANGLES, GL_UNSIGNED_INT from the VAO's EBO
+    int first_instance;
+    int instance_count;
+    unsigned char layer;               // painter's order between state groups
+} RenderCmd;
+
+typedef struct {
+    int commands;            // pushed this frame
+    int draws;               // draw calls after merging
+    int merged;              // commands folded into a neighbour
+    int state_changes;       // binds/uniform uploads actually issued
+    int redundant_skipped;   // binds a naive per-command replay would have issued on top
+} CmdListStats;
+
+typedef struct {
+    RenderCmd *cmds;
+    RenderCmd *scratch;      // radix sort ping-pong buffer
+    int count;
+    int capacity;
+    CmdListStats stats;      // of the last submit
+} CmdList;
+
+int  cmdlist_init(CmdList *l, int capacity);
+void cmdlist_shutdown(CmdList *l);
+void cmdlist_reset(CmdList *l);
+
+// copies *cmd and fills in its sort key; returns 0 when the list is full
+int  cmdlist_push(CmdList *l, const RenderCmd *cmd);
+void cmdlist_submit(CmdList *l);
+
+#endif // CMDLIST_H
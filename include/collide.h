@@ -0,0 +1,45 @@
+// collide.h
+#ifndef COLLIDE_H
+#define COLLIDE_H
+
+/* Collision boxes as structure of arrays: centres and collision half extents
+   (the drawn ones, *_SCALE_* and 0.5 already applied) in four float arrays, so
+   a batch test loads 8 (AVX2) or 4 (SSE2) walls per array per step. Each set
+   of boxes picks its kernel once, in collide_boxes_init, from what the CPU
+   supports, so sets owned by different threads share no state; every kernel
+   does the scalar test's float operations and so gives the same answers. */
+
+typedef enum {
+    COLLIDE_SCALAR = 0,
+    COLLIDE_SSE2 = 1,
+    COLLIDE_AVX2 = 2,
+    COLLIDE_KERNELS
+} CollideKernel;
+
+typedef struct {
+    float *x, *y;                // centres
+    float *hx, *hy;              // collision half extents
+    int count;
+    int capacity;
+    CollideKernel kernel;        // what collide_any runs on these boxes
+} CollideBoxes;
+
+// empty, with the widest kernel this CPU runs
+void collide_boxes_init(CollideBoxes *b);
+// room for count boxes; count is set, contents are left to the caller
+int  collide_boxes_resize(CollideBoxes *b, int count);
+// releases the arrays; the kernel choice is kept
+void collide_boxes_free(CollideBoxes *b);
+void collide_boxes_set(CollideBoxes *b, int i, float x, float y, float hx, float hy);
+
+// 1 if the box at (x, y) with collision half extents (hx, hy) overlaps any of
+// boxes [first, end); stops at the first hit
+int  collide_any(const CollideBoxes *b, int first, int end, float x, float y, float hx, float hy);
+
+// widest kernel this CPU runs; collide_boxes_init picks it
+CollideKernel collide_best_kernel(void);
+// 0 (and no change) if the CPU or the build lacks it; for benchmarks
+int  collide_boxes_use_kernel(CollideBoxes *b, CollideKernel k);
+const char *collide_kernel_name(CollideKernel k);
+
+#endif // COLLIDE_H
@@ -0,0 +1,64 @@
+// damage.h
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include <glad/glad.h>
+
+/* Damage-tracked presentation.
+   The scene lives in a persistent offscreen target, so a frame only has to
+   repaint what changed. Callers add changed regions (NDC boxes) during the
+   frame; they are kept as up to DAMAGE_MAX_RECTS disjoint rectangles, merged
+   only when they overlap or the list is full, so changes in opposite corners
+   stay two small regions. damage_begin then returns 0 when there is nothing
+   to redraw; otherwise it binds the scene and clears the regions, and the
+   frame is drawn once per region, scissored to it (damage_region), or once
+   unscissored after damage_all. damage_blit copies the scene to the window's
+   back buffer for the swap, scaled when the scene is smaller (dynres.h). */
+#define DAMAGE_MAX_RECTS 8
+
+typedef struct {
+    int x0, y0, x1, y1;   // pixels, max exclusive
+} DamageRect;
+
+typedef struct {
+    unsigned long long frames;     // damage_begin calls
+    unsigned long long idle;       // nothing to redraw
+    unsigned long long partial;    // scissored redraws
+    unsigned long long regions;    // scissored regions drawn, over the partial redraws
+    unsigned long long full;       // whole-target redraws
+    double pixels;                 // redrawn pixels, summed
+} DamageStats;
+
+typedef struct {
+    GLuint fbo;
+    GLuint color_rb;
+    int width, height;
+
+    int full;          // next redraw covers the whole target
+    int count;         // damaged regions in rects
+    DamageRect rects[DAMAGE_MAX_RECTS];
+
+    DamageStats stats;
+} Damage;
+
+int  damage_init(Damage *d, int width, int height);
+void damage_shutdown(Damage *d);
+// recreates the scene target when the size changed (and damages all of it)
+int  damage_resize(Damage *d, int width, int height);
+
+void damage_all(Damage *d);
+// centre and half extents in NDC, as in the world instances
+void damage_add_box(Damage *d, float cx, float cy, float hx, float hy);
+
+// 0 = nothing changed, skip the redraw; 1 = scene bound, viewport set and
+// damaged regions cleared: draw the frame for every region, then damage_end
+int  damage_begin(Damage *d);
+// scissors to region i of this redraw and returns 1, 0 past the last one;
+// after damage_all the one region is the whole target, unscissored
+int  damage_region(Damage *d, int i);
+void damage_end(Damage *d);
+// scene -> default framebuffer of dst_width x dst_height (bilinear when the
+// sizes differ), which stays bound afterwards
+void damage_blit(Damage *d, int dst_width, int dst_height);
+
+#endif // DAMAGE_H
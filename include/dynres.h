@@ -0,0 +1,34 @@
+// dynres.h
+#ifndef DYNRES_H
+#define DYNRES_H
+
+/* Dynamic resolution.
+   The scene is rendered offscreen at scale x the window size per axis and
+   upscaled on present. After every rendered frame the controller is fed the
+   measured frame time; it smooths it, and when it stays over the target it
+   shrinks the scale by the square root of the ratio (cost follows the pixel
+   count), and when it stays well under it grows the scale back. Scales are
+   quantized and changes are spaced out, so the target is not reallocated
+   every frame and GPU times that arrive late describe the size they ran at. */
+#define DYNRES_STEP (1.0f / 32.0f)   // scale quantum
+#define DYNRES_COOLDOWN 30           // frames between changes
+#define DYNRES_HEADROOM 0.75f        // grow only below this fraction of the target
+
+typedef struct {
+    float target_ms;
+    float min_scale, max_scale;
+    float scale;                     // current, per axis
+    float smoothed_ms;               // 0 = no sample since the last change
+    int cooldown;                    // frames until the next change may happen
+    unsigned long long changes;
+} DynRes;
+
+// starts at max_scale; scales are clamped to (0, 1]
+void dynres_init(DynRes *r, float target_ms, float min_scale, float max_scale);
+// feeds one frame's time, ms; 1 when the scale changed
+int  dynres_update(DynRes *r, float frame_ms);
+// render target size for a window of width x height; at least 1 x 1 unless
+// the window is empty (minimized)
+void dynres_size(const DynRes *r, int width, int height, int *out_w, int *out_h);
+
+#endif // DYNRES_H
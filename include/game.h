@@ -3,34 +3,174 @@
 #define GAME_H
 
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
 
-typedef struct { float x, y; float halfW, halfH; } Rect;
-typedef struct { float x, y, r; } Pellet;
+#include "sim.h"
+#include "stream.h"
+#include "cmdlist.h"
+#include "timing.h"
+#include "damage.h"
+#include "grid.h"
+#include "board.h"
+#include "softrast.h"
+#include "sprites.h"
 
+// shape ids understood by the world shader (Instance.shape)
+enum { SHAPE_RECT = 0, SHAPE_CIRCLE = 1, SHAPE_PACMAN = 2, SHAPE_GHOST = 3 };
+
+// Pellet storage on the GPU follows the sim's PelletStorage (sim.h):
+// COMPACT: the two slots an eat touches are patched in the world buffer
+//          (the eaten one becomes zero-sized).
+// BITMASK: the alive bits are mirrored into a buffer texture the vertex
+//          shader uses to cull.
+
+// How walls and pellets are drawn (the player is always an instance).
+// INSTANCES: instanced draw of the grid cells on screen.
+// TILES: the level baked into a tile texture, one fullscreen pass (board.h).
+// SOFTWARE: the instances the INSTANCES path would draw, rasterized on the
+//           CPU (softrast.h); fixed by game_init_software, no GL at all.
+typedef enum { RENDER_INSTANCES = 0, RENDER_TILES = 1, RENDER_SOFTWARE = 2 } WorldRenderer;
+
+// one instance of the world draw: transform (centre + full extents in world units,
+// render scales already applied), colour and shape. Matches shader attrs 1/2.
 typedef struct {
-    Rect *walls;
-    int wall_count;
-    Pellet *pellets;
-    int pellet_count;
+    float x, y, sx, sy;
+    float r, g, b, shape;
+} Instance;
 
-    // player
-    float posX, posY;
-    float half;   // half-size of player square
-    float speed;  // units per second
+// instances at the tail of the world buffer that are rewritten every frame:
+// the player, then the ghosts (zero-sized past the sim's ghost_count)
+#define WORLD_DYNAMIC_SLOTS (1 + GAME_GHOSTS)
+
+// Immutable copy of everything game_render needs from one simulation step.
+// Lets the simulation hand frames to a renderer on another thread; owns its
+// own copy of the pellet alive bits (BITMASK storage only).
+typedef struct {
+    unsigned long long tick;
+    float posX, posY, half;
+    float prevX, prevY;          // the tick before, unblended (ghosts: px, py)
+    int facing;
+    float time;
+    GameGhost ghosts[GAME_GHOSTS];
+    int ghost_count;             // sim.ghost_count: the ghosts drawn
+    float camX, camY, viewHalfX, viewHalfY;
+    float prevCamX, prevCamY;    // the tick before, unblended
+    double blend_start;          // real time the blend between the two ticks is at 0, for
+                                 // game_snapshot_blend on another thread; 0 = unset
+    int pellets_left;
+    int fb_width, fb_height;
+    unsigned char *pellet_alive;
+    int alive_bytes;
+} FrameSnapshot;
+
+typedef struct {
+    // the simulation; game_render draws snapshots of it and its level
+    Sim sim;
 
     // GL state needed by renderer
     GLuint vao;
+    GLuint quad_vbo, quad_ebo;   // the unit quad behind vao, for other instanced VAOs
     GLuint program;
+
+    GLint loc_uViewport;
+    GLint loc_uPelletBase;
+    GLint loc_uPelletCount;
+    GLint loc_uPelletAlive;
+    GLint loc_uTint;
+    GLint loc_uInstanceBase;
+    GLint loc_uCamera;
+
+    // everything is one instanced draw from the world buffer:
+    // [walls | pellets | WORLD_DYNAMIC_SLOTS], the level baked once per level
+    GLuint world_vao;
+    GLuint world_vbo;
+    GLuint alive_buf;   // R8UI texture buffer over pellet_alive
+    GLuint alive_tex;
+    unsigned char *gpu_alive;  // renderer's copy of what alive_buf holds
+    int gpu_alive_bytes;
+    CmdInstanceLayout world_layout;
+
+    WorldRenderer renderer;
+    Board board;        // RENDER_TILES
+    SoftRaster soft;    // RENDER_SOFTWARE: game_render draws into soft.pixels
+    SoftQuad *soft_quads;
+    int soft_quad_capacity;
+    Sprites sprites;    // actors from the sprite sheet when sprites.program is set
+
+    // draws are queued here and submitted state-sorted once per frame
+    CmdList cmds;
+
+    // per-frame instances are written into a streaming ring and copied into
+    // the dynamic tail of the world buffer on the GPU
+    StreamBuffer stream;
+
+    // walls found on screen by the last game_render, from sim.wall_bins in
+    // world buffer order; wall_mark[i] == wall_stamp once wall i is listed
+    int *visible_walls;
+    unsigned *wall_mark;
+    unsigned wall_stamp;
+
+    // draw calls issued and instances submitted by the last game_render;
+    // instances are all of the culled ranges, eaten pellets included, on
+    // every renderer
+    int draw_calls;
+    int visible_instances;
+
+    // GL_TIME_ELAPSED per render section; timers.frame ids the last game_render
+    GpuTimers timers;
+
+    // what the last game_render drew, for game_collect_damage
+    Instance drawn_actors[WORLD_DYNAMIC_SLOTS];  // shape = sprite layer when drawn as sprites
+    int drawn_pellets_left;
+    float drawn_camX, drawn_camY;
+    int drawn_valid;         // 0 after level/storage changes: everything is damaged
 } Game;
 
-int game_init(Game *g, GLuint program, GLuint vao);
-void game_update(Game *g, float dt, int up, int down, int left, int right);
-void game_render(Game *g, GLint loc_uOffset, GLint loc_uScale, GLint loc_uColor);
+// loads the classic level
+int game_init(Game *g, GLuint program, GLuint vao, GLuint quad_vbo, GLuint quad_ebo);
+// same, but renders with RENDER_SOFTWARE on threads (<= 0: one per CPU) and
+// makes no GL calls, so no context is needed
+int game_init_software(Game *g, int threads);
+// sim_load_level, then rebuild the level's GPU buffers
+int game_load_level(Game *g, const Level *lv);
+// sim_set_pellet_storage; re-uploads the pellet instances once
+int game_set_pellet_storage(Game *g, PelletStorage mode);
+// switch renderer; RENDER_TILES needs the board program (gfx "board"),
+// which stays owned by the caller like the world program. A game started
+// with game_init_software cannot switch, nor can a GL one switch to software.
+int game_set_renderer(Game *g, WorldRenderer r, GLuint board_program);
+// draw the player and ghosts as animated sprites (gfx "sprite" program, owned
+// by the caller) in one instanced draw over the world; 0 switches back to the
+// world shader's shapes. GL renderers only.
+int game_set_sprites(Game *g, GLuint sprite_program);
+void game_render(Game *g, const FrameSnapshot *s, int fb_width, int fb_height);
+// same into d's scene between damage_begin and damage_end, every draw
+// repeated for each damaged region (GL renderers)
+void game_render_damaged(Game *g, const FrameSnapshot *s, Damage *d);
+// adds every region that would look different from the last game_render
+// when drawing s; call before game_render
+void game_collect_damage(Game *g, const FrameSnapshot *s, Damage *d);
+
 void game_shutdown(Game *g);
 
-// helper
-int rects_overlap(float ax, float ay, float aHalfX, float aHalfY,
-                  float bx, float by, float bHalfX, float bHalfY);
+// Snapshots and world instances (snapshot.c) need only a Sim: no GL, and no
+// Game, for drivers that simulate and draw by themselves.
+// snapshots: alloc sizes the alive copy for the sim's current level
+int game_snapshot_alloc(FrameSnapshot *s, const Sim *sim);
+// actors and camera blended between the last two ticks by alpha in [0, 1]
+// (1 = the last tick); pellets and everything else as of the last tick
+void game_snapshot(const Sim *sim, float alpha, FrameSnapshot *s);
+// out = s (taken with alpha 1) with its actors and camera blended by alpha
+// between the tick before and its own; out shares s's alive bits
+void game_snapshot_blend(const FrameSnapshot *s, float alpha, FrameSnapshot *out);
+void game_snapshot_free(FrameSnapshot *s);
+
+void game_wall_instance(const Rect *w, Instance *out);
+void game_pellet_instance(const Pellet *p, Instance *out);
+// the level as the world buffer holds it: wall_count walls, then pellet_count
+// pellets in storage order, the ones already eaten zero-sized
+void game_level_instances(const Sim *sim, Instance *out);
+// the WORLD_DYNAMIC_SLOTS actor instances of a snapshot, as the world buffer's
+// tail holds them
+void game_actor_instances(const FrameSnapshot *s, Instance *out);
 
 #endif // GAME_H
@@ -0,0 +1,33 @@
+// gfx.h
+#ifndef GFX_H
+#define GFX_H
+
+#include <glad/glad.h>
+
+/* GL setup shared by every front-end (window, headless): the unit quad all
+   instances are drawn with and the shader programs. */
+typedef struct {
+    GLuint vao, vbo, ebo;   // 4 vertices in [-0.5, 0.5], 6 indices
+} GfxQuad;
+
+int    gfx_create_quad(GfxQuad *q);
+// The cache directory a --shader-cache option names: not given (NULL) is the
+// per-user cache, $XDG_CACHE_HOME/pman or ~/.cache/pman (%LOCALAPPDATA%\pman
+// on Windows), created on first use; "none" and an uncreatable per-user
+// directory give NULL, no caching.
+const char *gfx_cache_dir(const char *option);
+void   gfx_destroy_quad(GfxQuad *q);
+// Builds a program from <shader_dir>/<name>.vs and <name>.fs ("basic" is the
+// world program, "board" the tile board). With a cache_dir, the linked binary
+// is restored from / saved to <cache_dir>/<name>-<key>.glbin, key = hash of
+// both sources and the GL vendor, renderer and version; saving one deletes
+// the program's other <name>-*.glbin files there. *from_cache
+// (optional) tells whether compile and link were skipped. 0 on failure
+// (errors go to stderr).
+GLuint gfx_create_program(const char *shader_dir, const char *name, const char *cache_dir, int *from_cache);
+// same with the stages from different files, <vs_name>.vs and <fs_name>.fs;
+// the cache file is named after vs_name
+GLuint gfx_create_program_pair(const char *shader_dir, const char *vs_name, const char *fs_name,
+                               const char *cache_dir, int *from_cache);
+
+#endif // GFX_H
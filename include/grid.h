@@ -0,0 +1,53 @@
+// grid.h
+#ifndef GRID_H
+#define GRID_H
+
+/* Uniform loose grid over a static set of boxes.
+   Every item is binned by its centre only, so it lives in exactly one cell;
+   queries grow the box by the largest item half-extent instead. grid_build
+   returns the items in cell order (row-major), which callers use to lay the
+   items out so that a run of cells in one row is one contiguous index range:
+   [start[row * cols + x0], start[row * cols + x1 + 1]). */
+typedef struct { float x, y, hx, hy; } GridItem;
+
+typedef struct {
+    float min_x, min_y;        // world position of cell (0, 0)
+    float cell;                // cell edge length
+    int cols, rows;
+    int *start;                // cols * rows + 1 offsets, CSR over the cell-ordered items
+    float max_hx, max_hy;      // largest item half extents
+} Grid;
+
+/* Uniform grid listing every item in each cell its box touches, for overlap
+   tests against items of any length (walls): a query visits only the cells
+   under its own box, so its cost follows the items near it, however long the
+   longest item is. Items are referred to by index and may repeat across the
+   cells of one query. */
+typedef struct {
+    float min_x, min_y;        // world position of cell (0, 0)
+    float cell;                // cell edge length
+    int cols, rows;
+    int *start;                // cols * rows + 1 offsets into items
+    int *items;                // item indices, cell by cell
+} GridBins;
+
+// order receives count item indices sorted by cell (stable within a cell)
+int  grid_build(Grid *gr, float min_x, float min_y, float max_x, float max_y, float cell,
+                const GridItem *items, int count, int *order);
+void grid_free(Grid *gr);
+
+// cell index of a point, clamped to the grid
+int  grid_cell_of(const Grid *gr, float x, float y);
+// cells whose items may overlap [x0,x1] x [y0,y1], clamped to the grid;
+// 0 for an empty grid or box
+int  grid_query(const Grid *gr, float x0, float y0, float x1, float y1,
+                int *cx0, int *cy0, int *cx1, int *cy1);
+
+int  grid_bins_build(GridBins *b, float min_x, float min_y, float max_x, float max_y, float cell,
+                     const GridItem *items, int count);
+void grid_bins_free(GridBins *b);
+// cells touching [x0,x1] x [y0,y1], clamped to the grid; 0 for an empty grid or box
+int  grid_bins_query(const GridBins *b, float x0, float y0, float x1, float y1,
+                     int *cx0, int *cy0, int *cx1, int *cy1);
+
+#endif // GRID_H
@@ -0,0 +1,41 @@
+// headless.h
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <glad/glad.h>
+
+/* Offscreen GL 3.3 core context for machines without a display.
+   Backends are compiled in with -DPMAN_HAVE_EGL (EGL surfaceless platform,
+   e.g. Mesa llvmpipe) and/or -DPMAN_HAVE_OSMESA; headless_init tries them in
+   that order. There is no default framebuffer, so frames are drawn into an
+   RGBA8 FBO that headless_begin_frame binds. */
+typedef enum {
+    HEADLESS_NONE = 0,
+    HEADLESS_EGL,
+    HEADLESS_OSMESA
+} HeadlessBackend;
+
+typedef struct {
+    int width, height;
+    HeadlessBackend backend;
+
+    void *egl_display;          // EGLDisplay
+    void *egl_context;          // EGLContext
+    void *osmesa_context;       // OSMesaContext
+    unsigned char *osmesa_buf;  // OSMesa wants a bound colour buffer even if we never draw to it
+
+    GLuint fbo;
+    GLuint color_rb;
+} Headless;
+
+// creates the context, makes it current on the calling thread and loads GL
+int  headless_init(Headless *h, int width, int height);
+void headless_shutdown(Headless *h);
+const char *headless_backend_name(const Headless *h);
+
+// bind the FBO, set the viewport and clear it to the window's clear colour
+void headless_begin_frame(Headless *h);
+// reads the frame as width*height*4 bytes, top row first
+int  headless_read_rgba(Headless *h, unsigned char *out);
+
+#endif // HEADLESS_H
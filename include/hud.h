@@ -0,0 +1,51 @@
+// hud.h
+#ifndef HUD_H
+#define HUD_H
+
+#include <glad/glad.h>
+
+/* Text overlay drawn from a glyph atlas in one instanced draw.
+   A built-in 5x7 bitmap font (printable ASCII up to 'Z', lowercase drawn as
+   uppercase) is baked into an R8 texture at init. Every character on screen
+   is one instance in a single buffer: static strings are written once when
+   added, fields are fixed-width slots whose changed characters alone are
+   re-uploaded by hud_set. */
+#define HUD_GLYPH_W 6            // cell, font pixels: 5 columns + spacing
+#define HUD_GLYPH_H 8            // 7 rows + spacing
+#define HUD_MAX_GLYPHS 512
+#define HUD_MAX_FIELDS 16
+#define HUD_FIELD_MAX 32         // characters per field
+
+typedef struct {
+    int first;                   // instance slot of the first character
+    int width;                   // characters
+    char text[HUD_FIELD_MAX];    // what the slots hold now
+} HudField;
+
+typedef struct {
+    GLuint program;              // gfx "hud", owned by the caller
+    GLint loc_uViewport;
+    GLint loc_uFont;
+    GLuint vao, vbo;
+    GLuint font_tex;
+    int scale;                   // screen pixels per font pixel
+    int count;                   // glyph slots in use
+    HudField fields[HUD_MAX_FIELDS];
+    int field_count;
+    unsigned long long glyph_uploads;  // characters written to the GPU so far
+} Hud;
+
+// quad_vbo / quad_ebo are the shared unit quad (gfx_create_quad)
+int  hud_init(Hud *h, GLuint program, GLuint quad_vbo, GLuint quad_ebo, int scale);
+void hud_shutdown(Hud *h);
+// static text, top-left corner at x, y (pixels from the top-left of the
+// window); 0 when the glyph buffer is full
+int  hud_text(Hud *h, int x, int y, float r, float g, float b, const char *s);
+// reserves a field of width characters, initially blank; -1 when full
+int  hud_field(Hud *h, int x, int y, int width, float r, float g, float b);
+// sets a field's text (cut or space-padded to its width); returns 1 when
+// any character changed
+int  hud_set(Hud *h, int field, const char *s);
+void hud_draw(const Hud *h, int fb_width, int fb_height);
+
+#endif // HUD_H
@@ -0,0 +1,19 @@
+// level.h
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "sim.h"
+
+/* Level builders. Each fills a Level whose walls array is owned by the
+   Level (release with level_free); sim_load_level copies what it needs. */
+
+// the original single-screen layout, bounds [-1, 1]
+int  level_classic(Level *lv);
+// random perfect maze of cols x rows corridor cells (recursive backtracker),
+// centred on the origin; the same seed always gives the same maze
+int  level_maze(Level *lv, int cols, int rows, unsigned seed);
+// level_maze from a command line spec "WxH" or "WxH,seed"
+int  level_maze_from_spec(Level *lv, const char *spec);
+void level_free(Level *lv);
+
+#endif // LEVEL_H
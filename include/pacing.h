@@ -0,0 +1,38 @@
+// pacing.h
+#ifndef PACING_H
+#define PACING_H
+
+/* Low-latency frame pacing.
+   With vsync the swap holds a frame until the next vblank, so input sampled
+   right after the previous swap is almost a refresh old by the time it shows.
+   The pacer remembers when swaps complete (the vblank phase) and how long the
+   work between sampling input and submitting the swap takes, and pacer_wait
+   sleeps until that long before the next vblank. Waits sleep the bulk in the
+   OS and spin the last stretch on the monotonic clock, because OS sleeps can
+   overshoot by a scheduler tick. */
+#define PACER_HISTORY 32
+
+typedef struct {
+    double period;                  // refresh interval, s
+    double margin;                  // slack on top of the work estimate, s
+    double last_present;            // when the last swap completed, 0 = none yet
+    double work[PACER_HISTORY];     // input sampled -> swap submitted, recent frames
+    int work_count, work_next;
+    double target;                  // vblank the last pacer_wait aimed for
+    unsigned long long frames;      // presents seen
+    unsigned long long missed;      // presents that completed after their target vblank
+} Pacer;
+
+// monotonic seconds
+double pacing_now(void);
+// sleep, then spin, until pacing_now() >= t
+void   pacing_sleep_until(double t);
+
+void   pacer_init(Pacer *p, double refresh_hz, double margin_ms);
+void   pacer_shutdown(Pacer *p);
+// returns when the next frame should sample input
+void   pacer_wait(Pacer *p);
+// after the swap completed; all three are pacing_now() values
+void   pacer_presented(Pacer *p, double sampled, double submitted, double presented);
+
+#endif // PACING_H
@@ -0,0 +1,53 @@
+// render_thread.h
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "capture.h"
+#include "game.h"
+#include "triplebuf.h"
+
+/* Renders on its own thread, which owns the window's GL context.
+   The simulation fills render_thread_back() with game_snapshot (alpha 1,
+   blend_start set) and calls render_thread_publish(); the render thread always
+   draws the newest published snapshot, blended between its two ticks by its
+   own clock, so a slow swap never blocks sim_update. The GPU timer results of
+   game_render are collected here too, into a ring only this thread touches,
+   and their averages published with the other counters.
+   Requires PELLETS_BITMASK storage and no level changes while running. */
+typedef struct {
+    GLFWwindow *window;
+    Game *game;
+    Capture *capture;         // NULL = no recording; owned by the caller
+
+    FrameSnapshot slots[3];
+    TripleBuffer snapshots;
+
+    FrameTimeRing times;      // render thread only: CPU render and GPU pass times
+
+    pthread_t thread;
+    int running;
+    atomic_int quit;
+
+    // written by the render thread, readable from any thread
+    atomic_uint frames;       // frames presented
+    atomic_uint stale_frames; // frames that re-drew an already presented snapshot
+    atomic_int draw_calls;    // of the last frame
+    atomic_uint render_us;    // CPU render time, averaged over the recent frames
+    atomic_uint gpu_us;       // GPU time of the same frames, as far as results are back
+} RenderThread;
+
+// the calling thread must not have the window's context current; capture,
+// when given, is fed every presented frame and must be closed after stop
+int  render_thread_start(RenderThread *rt, GLFWwindow *window, Game *game, Capture *capture);
+FrameSnapshot *render_thread_back(RenderThread *rt);
+void render_thread_publish(RenderThread *rt);
+// joins the thread; the context is released and can be made current again
+void render_thread_stop(RenderThread *rt);
+
+#endif // RENDER_THREAD_H
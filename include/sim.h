@@ -0,0 +1,160 @@
+// sim.h
+#ifndef SIM_H
+#define SIM_H
+
+#include "collide.h"
+#include "grid.h"
+
+/* The simulation: level, pellets, player, ghosts and camera, with no GL or
+   window system anywhere, so it builds into its own library (see Readme) and
+   runs without a context. Game (game.h) wraps one for drawing; simbench
+   steps bare ones. */
+
+typedef struct { float x, y; float halfW, halfH; } Rect;
+typedef struct { float x, y, r; } Pellet;
+
+// walls plus the box the player and the camera stay inside (world units)
+typedef struct {
+    Rect *walls;
+    int wall_count;
+    float min_x, min_y, max_x, max_y;
+    float start_x, start_y;
+} Level;
+
+/* Stored half sizes -> drawn extents. Collisions use the drawn boxes, i.e.
+   these scales and another 0.5:
+   walls: halfW * 0.5f, halfH * 1.0f
+   pellets: r * 0.6f, r * 1.0f
+   player (and ghosts): half * 0.8f, half * 1.0f */
+#define WALL_SCALE_X 0.5f
+#define WALL_SCALE_Y 1.0f
+#define PELLET_SCALE_X 0.6f
+#define PELLET_SCALE_Y 1.0f
+#define PLAYER_SCALE_X 0.8f
+#define PLAYER_SCALE_Y 1.0f
+
+/* Fixed step. Every tick advances the sim by SIM_DT whatever the frame rate,
+   so a run is reproducible from its per-tick input and no step is longer than
+   the thin walls allow; SimClock turns real time into ticks and drawing
+   blends the last two ticks (game_snapshot). */
+#define SIM_HZ 120
+#define SIM_DT (1.0f / SIM_HZ)
+// ticks one advance may run to catch up; the rest of a longer stall is dropped
+#define SIM_MAX_STEPS 8
+
+// which way an actor looks (and a ghost walks); sprite facings use this order
+enum { FACE_RIGHT = 0, FACE_LEFT = 1, FACE_UP = 2, FACE_DOWN = 3 };
+
+// ghosts wander the level; they neither chase nor catch the player yet, and
+// are off unless asked for (sim_set_ghost_count): they never stop moving, so
+// with ghosts no frame is ever idle
+#define GAME_GHOSTS 4
+typedef struct {
+    float x, y;
+    float px, py;                // position before the last sim_update
+    int dir;                     // FACE_*, kept until blocked or a random turn
+    float r, g, b;
+} GameGhost;
+
+// How eaten pellets are dropped.
+// COMPACT: swap-remove within the pellet's grid cell; pellet_moved reports
+//          the two touched slots.
+// BITMASK: pellets never changes; eaten = cleared bit in pellet_alive.
+typedef enum { PELLETS_COMPACT = 0, PELLETS_BITMASK = 1 } PelletStorage;
+
+typedef struct {
+    // walls and pellets are kept in grid cell order (see grid.h), so the
+    // cells of one grid row that are on screen are one contiguous range
+    Rect *walls;
+    int wall_count;
+    Pellet *pellets;
+    int pellet_count;            // slots, eaten ones included; fixed per level
+    PelletStorage pellet_storage;
+    unsigned char *pellet_alive; // 1 bit per pellet (BITMASK storage)
+    int *pellet_live;            // per pellet_grid cell: live pellets at the head of its range (COMPACT)
+    int pellets_left;
+    float pellet_radius;         // of the current level
+    Grid wall_grid;
+    Grid pellet_grid;
+    GridBins wall_bins;          // walls by every cell their collision box touches
+    CollideBoxes wall_boxes;     // wall_bins' items as collision boxes, cell by cell
+
+    // level bounds, world units
+    float min_x, min_y, max_x, max_y;
+
+    // lattice the pellets were generated on: cell (i, j) spans
+    // lattice_x + i * lattice_spacing ..., pellets sit on cell centres
+    float lattice_x, lattice_y, lattice_spacing;
+    int lattice_cols, lattice_rows;
+    int *lattice_pellet;         // per lattice cell, row-major: slot of its pellet, -1 = none
+
+    // camera: world point at the centre of the screen and the half extents of
+    // the visible rectangle; follows the player, clamped to the level
+    float camX, camY;
+    float viewHalfX, viewHalfY;
+    float prevCamX, prevCamY;    // before the last sim_update
+
+    // player
+    float posX, posY;
+    float prevX, prevY;  // before the last sim_update
+    float half;   // half-size of player square
+    float speed;  // units per second
+    int facing;   // FACE_*, last direction pressed
+
+    GameGhost ghosts[GAME_GHOSTS];
+    int ghost_count;             // ghosts[0, ghost_count) walk and are drawn; 0 after sim_init
+    unsigned ghost_rng;
+
+    unsigned long long tick;  // sim_update calls
+    float time;               // seconds simulated, drives animations
+
+    // COMPACT storage: called for each pellet slot whose contents an eat
+    // changed (a survivor swapped in, or the eaten one parked at the end of
+    // its cell), in that order; NULL = nobody mirrors the pellets
+    void (*pellet_moved)(void *user, int idx);
+    void *user;
+} Sim;
+
+int  sim_init(Sim *s);
+// copy the level's walls, regenerate pellets, rebuild the grids and put the
+// player and ghosts on the level's start
+int  sim_load_level(Sim *s, const Level *lv);
+// reorders / rebuilds the pellet state for the new storage
+int  sim_set_pellet_storage(Sim *s, PelletStorage mode);
+int  sim_pellet_alive(const Sim *s, int idx);
+// size of the alive bitmask for the current level
+int  sim_pellet_alive_bytes(const Sim *s);
+// how many ghosts walk, clamped to [0, GAME_GHOSTS]; the rest stay on the start
+void sim_set_ghost_count(Sim *s, int count);
+// one tick; dt is SIM_DT everywhere except benchmarks of other rates
+void sim_update(Sim *s, float dt, int up, int down, int left, int right);
+void sim_shutdown(Sim *s);
+
+// steers a player nobody plays (benchmarks, the spectator wall): wanders like
+// the ghosts, keeping a direction until it stops moving, or at random
+typedef struct {
+    unsigned rng;                // xorshift state, never 0
+    int dir;                     // FACE_*
+    float last_x, last_y;        // player position before the last step
+} SimPilot;
+
+void sim_autopilot_init(SimPilot *p, unsigned seed, int dir);
+// picks the direction and runs one sim_update with it
+void sim_autopilot_step(SimPilot *p, Sim *s, float dt);
+
+typedef struct {
+    double acc;                  // real seconds not simulated yet, < SIM_DT after an advance
+    unsigned long long dropped;  // ticks given up after stalls
+} SimClock;
+
+void  sim_clock_init(SimClock *c);
+// adds dt real seconds; returns how many ticks to run now, at most SIM_MAX_STEPS
+int   sim_clock_advance(SimClock *c, double dt);
+// how far real time is into the next tick, [0, 1): the blend between the
+// last two ticks to draw
+float sim_clock_alpha(const SimClock *c);
+
+// wall whose visible (and colliding) box is centre +- vis half extents
+Rect sim_wall_from_box(float cx, float cy, float vis_hx, float vis_hy);
+
+#endif // SIM_H
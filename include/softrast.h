@@ -0,0 +1,78 @@
+// softrast.h
+#ifndef SOFTRAST_H
+#define SOFTRAST_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+/* CPU rasterizer for the world shader's quads, for machines without any GL.
+   It replays the GL pipeline the world draw goes through step by step, in the
+   same float operations: viewport transform, snapping to 1/256 pixel, pixel
+   centre coverage with the top-left fill rule, then the fragment shader's
+   shape cut-outs. Frames therefore match the GL path pixel for pixel.
+
+   The framebuffer is split into SOFT_TILE pixel tiles; softrast_draw bins the
+   quads by tile and a pool of worker threads takes whole tiles, so no two
+   threads ever write the same pixel and quads stay in submission order within
+   every tile. Spans are filled 8 (AVX2) or 4 (SSE2) pixels at a time. */
+#define SOFT_TILE 64
+
+// one quad as the world vertex shader sees it: NDC centre and full extents
+// (its c and e), colour as RGBA8 with R in the lowest byte, world shape id
+typedef struct {
+    float cx, cy, ex, ey;
+    uint32_t color;
+    int shape;
+} SoftQuad;
+
+// quad after setup: covered pixels [x0, x1) x [y0, y1), GL's bottom-up rows,
+// and the window-space centre/half extents the fragment stage reads
+typedef struct {
+    int x0, y0, x1, y1;
+    float center_x, center_y, half_x, half_y;
+    uint32_t color;
+    int shape;
+} SoftPrim;
+
+typedef struct {
+    int width, height;
+    uint32_t *pixels;        // RGBA8 like SoftQuad.color, bottom row first
+    int tiles_x, tiles_y;
+
+    // the frame being drawn: prims and, per tile, the prims touching it
+    SoftPrim *prims;
+    int prim_count, prim_capacity;
+    int *bin_start;          // tiles + 1 offsets into bin_items
+    int *bin_items;
+    int bin_capacity;
+    uint32_t clear_color;
+
+    // worker pool; the calling thread rasterizes too
+    int threads;             // including the caller
+    int span_kernel;         // row fillers (softrast.c), the widest the CPU runs
+    pthread_t *workers;
+    int worker_count;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    unsigned long long generation;  // bumped per frame, under lock
+    int busy;                // workers still on the current frame
+    int quit;
+    atomic_int next_tile;
+} SoftRaster;
+
+// threads <= 0 picks one per online CPU
+int  softrast_init(SoftRaster *r, int threads);
+void softrast_shutdown(SoftRaster *r);
+// pixels the picked row fillers handle per step: 8 (AVX2), 4 (SSE2) or 1
+int  softrast_lanes(const SoftRaster *r);
+// no-op when the size is unchanged
+int  softrast_resize(SoftRaster *r, int width, int height);
+// clears to clear_color and draws quads in order, like glClear plus one
+// instanced draw; returns when the frame is complete
+void softrast_draw(SoftRaster *r, const SoftQuad *quads, int count, uint32_t clear_color);
+// width*height*4 bytes, top row first (as headless_read_rgba)
+void softrast_read_rgba(const SoftRaster *r, unsigned char *out);
+
+#endif // SOFTRAST_H
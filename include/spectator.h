@@ -0,0 +1,71 @@
+// spectator.h
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include <glad/glad.h>
+
+#include "game.h"
+
+/* Spectator wall: many independent games drawn side by side into the tiles
+   of one atlas framebuffer.
+
+   Every game's walls, pellets and actors live in one instance buffer
+   [walls of all games | pellets of all games | actors of all games], the
+   actors last so they draw over the levels; each instance is tagged
+   with its game and, for pellets, its bit in one alive texture that holds
+   every game's BITMASK bits back to back. The spectator program maps each
+   instance through its game's camera into its game's tile and clips it to
+   that tile, so the whole wall is a single instanced draw whatever the
+   number of games. Per frame only the actors (WORLD_DYNAMIC_SLOTS per game,
+   ghosts that are off zero-sized), the cameras and changed alive bytes are
+   uploaded. */
+typedef struct {
+    Sim *sims;               // the games, owned by the caller, game_count of them
+    int game_count;
+    int cols, rows;          // tile grid, row 0 at the top
+    int tile_w, tile_h;      // pixels
+    int width, height;       // atlas, pixels
+
+    GLuint program;          // gfx "spectator" + "basic" pair, owned by the caller
+    GLint loc_uAtlas;
+    GLint loc_uViews;
+    GLint loc_uPelletAlive;
+
+    GLuint fbo;
+    GLuint color_rb;         // RGBA8 atlas
+
+    GLuint vao;
+    GLuint vbo;              // [walls | pellets | actors], see above
+    int instance_count;
+    int actor_base;          // first actor instance
+
+    GLuint view_buf;         // RGBA32F buffer texture, 2 texels per game:
+    GLuint view_tex;         // camera (centre.xy, 1 / half.xy), tile (x, y, w, h)
+    float *views;
+
+    GLuint alive_buf;        // R8UI buffer texture over every game's alive bits
+    GLuint alive_tex;
+    int *alive_offset;       // per game, first byte; game_count + 1 entries
+    unsigned char *gpu_alive;
+
+    int draw_calls;          // of the last spectator_render
+} Spectator;
+
+// lays the games out in a near-square grid of tile_w x tile_h tiles and bakes
+// their current levels; switches every game to PELLETS_BITMASK storage.
+// quad_vbo / quad_ebo are the shared unit quad (gfx_create_quad)
+int  spectator_init(Spectator *sp, GLuint program, GLuint quad_vbo, GLuint quad_ebo,
+                    Sim *sims, int game_count, int tile_w, int tile_h);
+void spectator_shutdown(Spectator *sp);
+// re-bake after any game loaded a level or changed pellet storage
+int  spectator_rebuild(Spectator *sp);
+// draws every game's current state into the atlas, actors and cameras blended
+// between the last two ticks by alpha (see game_snapshot); leaves the atlas
+// FBO bound
+void spectator_render(Spectator *sp, float alpha);
+// scales the atlas into the default framebuffer, keeping its aspect
+void spectator_blit(const Spectator *sp, int fb_width, int fb_height);
+// width*height*4 bytes of the atlas, top row first
+int  spectator_read_rgba(const Spectator *sp, unsigned char *out);
+
+#endif // SPECTATOR_H
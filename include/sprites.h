@@ -0,0 +1,54 @@
+// sprites.h
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <glad/glad.h>
+
+/* Animated actor sprites.
+   Every frame of every animation is one layer of a single GL_TEXTURE_2D_ARRAY,
+   drawn at init, so switching frames or actors never rebinds a texture. Each
+   sprite is an instance carrying its world transform, a tint and its layer;
+   all actors on screen are one instanced draw (shaders/sprite.*).
+   Texels with alpha 255 take the instance's tint, alpha 128 keep their own
+   colour (ghost eyes), alpha 0 are cut out. */
+#define SPRITE_SIZE 32           // texels per layer edge
+
+// animations, each drawn once per facing: right, left, up, down (game.h FACE_*)
+enum { SPRITE_ANIM_PACMAN = 0, SPRITE_ANIM_GHOST = 1, SPRITE_ANIMS };
+#define SPRITE_FACINGS 4
+
+typedef struct {
+    int first_layer;             // facing f, frame k is layer first_layer + f * frames + k
+    int frames;
+    float fps;
+} SpriteAnim;
+
+// one sprite; attrs 1 and 2 of sprite.vs, laid out like the world Instance
+typedef struct {
+    float x, y, sx, sy;          // centre and full extents, world units
+    float r, g, b, layer;        // tint, texture array layer
+} SpriteInstance;
+
+typedef struct {
+    GLuint program;              // gfx "sprite", owned by the caller
+    GLint loc_uCamera;
+    GLint loc_uSprites;
+    GLuint tex;                  // GL_TEXTURE_2D_ARRAY, RGBA8
+    int layers;
+    SpriteAnim anims[SPRITE_ANIMS];
+    GLuint vao, vbo;             // vbo: the caller's SpriteInstances, written each frame
+    int capacity;                // instances the vbo holds
+} Sprites;
+
+// quad_vbo / quad_ebo are the shared unit quad (gfx_create_quad); the vbo has
+// room for capacity instances
+int  sprites_init(Sprites *sp, GLuint program, GLuint quad_vbo, GLuint quad_ebo, int capacity);
+void sprites_shutdown(Sprites *sp);
+// layer showing anim for facing at time seconds, looping
+int  sprites_layer(const Sprites *sp, int anim, int facing, float time);
+// one instanced draw of the first n sprites in sp->vbo into the current
+// viewport, for the view centred on (cam_x, cam_y) with half extents
+// view_hx, view_hy
+void sprites_draw(Sprites *sp, int n, float cam_x, float cam_y, float view_hx, float view_hy);
+
+#endif // SPRITES_H
@@ -0,0 +1,44 @@
+// stream.h
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <glad/glad.h>
+
+/* Triple-buffered ring for per-frame vertex data.
+   With GL_ARB_buffer_storage the ring is one persistently mapped buffer split
+   into STREAM_SEGMENTS segments, each guarded by a fence; otherwise every frame
+   orphans the buffer and maps it fresh. */
+#define STREAM_SEGMENTS 3
+
+typedef struct {
+    unsigned long long frames;       // stream_begin calls
+    unsigned long long fence_waits;  // frames whose segment was still in use by the GPU
+    unsigned long long overflows;    // stream_alloc requests that did not fit
+} StreamStats;
+
+typedef struct {
+    GLuint buffer;
+    GLsizeiptr segment_size;
+    int persistent;              // 1 = persistent map, 0 = orphaning fallback
+
+    unsigned char *base;         // persistent: whole ring, orphaning: map until commit
+    GLsync fences[STREAM_SEGMENTS];
+    int segment;                 // segment being written this frame
+    GLsizeiptr used;             // bytes handed out from the current segment
+
+    StreamStats stats;
+} StreamBuffer;
+
+int   stream_init(StreamBuffer *s, GLsizeiptr segment_size);
+void  stream_shutdown(StreamBuffer *s);
+
+// start a frame: fences the previous segment, waits on the next one (or
+// orphans) and makes it writable
+int   stream_begin(StreamBuffer *s);
+// reserve bytes in the current segment; *offset receives the offset to use
+// with glVertexAttribPointer while s->buffer is bound. NULL when full.
+void *stream_alloc(StreamBuffer *s, GLsizeiptr size, GLintptr *offset);
+// call after the frame's writes and before the draws that read them
+void  stream_commit(StreamBuffer *s);
+
+#endif // STREAM_H
@@ -0,0 +1,89 @@
+// timing.h
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <glad/glad.h>
+
+/* Per-pass GPU timing and a ring of recent frame timings.
+   game_render brackets its sections with GL_TIME_ELAPSED queries. Each frame
+   uses its own query set out of GPU_TIMER_FRAMES, and gpu_timers_collect
+   reads back only the sets whose results are already available, so nothing
+   ever waits on the GPU. Results land in the FrameTimeRing entry of the frame
+   that issued them, next to the CPU update/render times recorded for it.
+   Passes are listed in the order game_render issues them. */
+typedef enum {
+    GPU_PASS_ALIVE_UPLOAD,   // pellet alive bits -> texture buffer (BITMASK storage only)
+    GPU_PASS_ACTOR_COPY,     // actor instances: stream ring -> world buffer tail or sprite buffer
+    GPU_PASS_BOARD,          // the tile board (RENDER_TILES only)
+    GPU_PASS_WORLD,          // the merged instanced draw of walls, pellets and actors
+    GPU_PASS_SPRITES,        // actors drawn as sprites
+    GPU_PASS_COUNT
+} GpuPass;
+
+#define GPU_TIMER_FRAMES 4
+#define FRAME_TIME_HISTORY 256
+
+typedef struct {
+    unsigned long long frame;          // id given to frame_times_push, ~0 = empty
+    float update_ms;                   // CPU: sim_update
+    float render_ms;                   // CPU: game_render, i.e. command submission
+    float gpu_ms[GPU_PASS_COUNT];
+    int gpu_valid;                     // gpu_ms filled in (arrives a few frames late)
+    float latency_ms;                  // input sampled -> swap completed, 0 = not presented
+} FrameTime;
+
+typedef struct {
+    FrameTime entries[FRAME_TIME_HISTORY];   // entry of frame f is f % FRAME_TIME_HISTORY
+    unsigned long long count;                // frames pushed
+    unsigned long long newest;               // id of the last push
+} FrameTimeRing;
+
+typedef enum {
+    FRAME_BOUND_UNKNOWN,   // no GPU result yet
+    FRAME_BOUND_SIM,       // sim_update took longest
+    FRAME_BOUND_DRIVER,    // submitting took longer than the GPU work it produced
+    FRAME_BOUND_GPU
+} FrameBound;
+
+typedef struct {
+    int frames;                        // entries summarized
+    float update_ms, render_ms, gpu_ms;   // averages; gpu over frames with results
+    float worst_ms;                    // largest update + max(render, gpu)
+    FrameBound worst_bound;
+    float latency_ms, latency_max_ms;  // over presented frames
+} FrameTimeSummary;
+
+typedef struct {
+    GLuint queries[GPU_TIMER_FRAMES][GPU_PASS_COUNT];
+    unsigned char issued[GPU_TIMER_FRAMES][GPU_PASS_COUNT];
+    unsigned long long frame_of[GPU_TIMER_FRAMES];   // frame id each set was issued for
+    int pending[GPU_TIMER_FRAMES];                   // set has unread results
+    int set;                                         // set used by the current frame
+    int active;                                      // pass being timed, -1 = none
+    unsigned long long frame;                        // id of the current frame
+    int started;                                     // begin_frame called at least once
+    unsigned long long missed;                       // sets overwritten before their results came back
+} GpuTimers;
+
+int  gpu_timers_init(GpuTimers *t);
+void gpu_timers_shutdown(GpuTimers *t);
+// moves to the next query set; frames are numbered 0, 1, 2... per call and
+// t->frame is the id the results get filed under
+void gpu_timers_begin_frame(GpuTimers *t);
+void gpu_timer_begin(GpuTimers *t, GpuPass pass);
+void gpu_timer_end(GpuTimers *t);
+// non-blocking: files every finished set into the ring
+void gpu_timers_collect(GpuTimers *t, FrameTimeRing *ring);
+
+void frame_times_init(FrameTimeRing *r);
+// records the CPU side of a frame; use the GpuTimers frame id so the GPU
+// results find their entry
+void frame_times_push(FrameTimeRing *r, unsigned long long frame, float update_ms, float render_ms);
+// input-to-present latency of a pushed frame, once its swap has completed
+void frame_times_set_latency(FrameTimeRing *r, unsigned long long frame, float latency_ms);
+FrameBound frame_time_bound(const FrameTime *f);
+const char *frame_bound_name(FrameBound b);
+// over the last n frames (fewer if the ring holds fewer)
+void frame_times_summary(const FrameTimeRing *r, int n, FrameTimeSummary *out);
+
+#endif // TIMING_H
@@ -0,0 +1,24 @@
+// triplebuf.h
+#ifndef TRIPLEBUF_H
+#define TRIPLEBUF_H
+
+#include <stdatomic.h>
+
+/* Lock-free single-producer/single-consumer triple buffer of slot indices.
+   The writer fills slot triple_back() and publishes it; the reader picks up
+   the most recent published slot with triple_acquire() and reads
+   triple_front(). Neither side ever waits; stale frames are simply dropped. */
+typedef struct {
+    atomic_int middle;  // slot index | TRIPLE_FRESH when not yet acquired
+    int back;           // owned by the writer
+    int front;          // owned by the reader
+} TripleBuffer;
+
+void triple_init(TripleBuffer *t);
+int  triple_back(const TripleBuffer *t);
+void triple_publish(TripleBuffer *t);
+// returns 1 when a newer slot became the front, 0 when nothing new was published
+int  triple_acquire(TripleBuffer *t);
+int  triple_front(const TripleBuffer *t);
+
+#endif // TRIPLEBUF_H
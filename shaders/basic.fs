@@ -0,0 +1,21 @@
+#version 330 core
+// World uber-shader, fragment stage. Shapes are cut out in window space, so a
+// pellet is an SDF circle inside its quad, etc.
+in vec3 vColor;
+flat in int vShape;
+flat in vec2 vCenter;
+flat in vec2 vHalf;
+out vec4 FragColor;
+void main() {
+    vec2 q = (gl_FragCoord.xy - vCenter) / vHalf;   // [-1,1] across the quad
+    float d = dot(q, q);
+    if (vShape == 1) {                              // circle
+        if (d > 1.0) discard;
+    } else if (vShape == 2) {                       // pac-man: circle minus mouth wedge
+        if (d > 1.0 || (q.x > 0.0 && abs(q.y) < q.x * 0.6)) discard;
+    } else if (vShape == 3) {                       // ghost: dome + wavy skirt
+        if (q.y > 0.0) { if (d > 1.0) discard; }
+        else if (q.y < -0.75 && fract((q.x + 1.0) * 1.5) > 0.5) discard;
+    }
+    FragColor = vec4(vColor, 1.0);
+}
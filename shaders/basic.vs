@@ -0,0 +1,35 @@
+#version 330 core
+// World uber-shader, vertex stage. One program draws every world object; per
+// instance it gets a transform (attr 1) and colour + shape id (attr 2).
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec4 aXform;        // centre.xy, extents.xy (world units)
+layout(location = 2) in vec4 aStyle;        // rgb, shape id
+uniform vec2 uViewport;
+uniform vec4 uCamera;                       // view centre.xy, 1 / view half extents.xy
+uniform int uInstanceBase;                  // first instance of this draw in the buffer
+uniform int uPelletBase;                    // first pellet instance, -1 = no alive mask
+uniform int uPelletCount;                   // pellet instances from uPelletBase on
+uniform vec3 uTint;
+uniform usamplerBuffer uPelletAlive;        // 1 bit per pellet
+out vec3 vColor;
+flat out int vShape;
+flat out vec2 vCenter;                      // window-space centre, pixels
+flat out vec2 vHalf;                        // window-space half extents
+void main() {
+    int pid = gl_InstanceID + uInstanceBase - uPelletBase;
+    if (uPelletBase >= 0 && pid >= 0 && pid < uPelletCount) {
+        uint bits = texelFetch(uPelletAlive, pid >> 3).r;
+        if (((bits >> uint(pid & 7)) & 1u) == 0u) {
+            gl_Position = vec4(2.0, 2.0, 2.0, 1.0);   // eaten: outside the clip volume
+            return;
+        }
+    }
+    vec2 c = (aXform.xy - uCamera.xy) * uCamera.zw;   // NDC
+    vec2 e = aXform.zw * uCamera.zw;
+    vec2 p = aPos * e + c;
+    vColor = aStyle.rgb * uTint;
+    vShape = int(aStyle.a);
+    vCenter = (c * 0.5 + 0.5) * uViewport;
+    vHalf = e * 0.25 * uViewport;
+    gl_Position = vec4(p, 0.0, 1.0);
+}
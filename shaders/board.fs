@@ -0,0 +1,40 @@
+#version 330 core
+// Tile board, fragment stage. Every pixel maps to world space, then to the
+// board texture laid over the pellet lattice: bit 0 of its own texel = wall,
+// bit 1 of its lattice cell's centre texel = live pellet. Colours match the
+// world shader's wall and pellet instances.
+uniform vec2 uViewport;
+uniform vec4 uCamera;                       // view centre.xy, 1 / view half extents.xy
+uniform vec4 uLattice;                      // origin.xy, cell edge, texels per cell
+uniform vec2 uPelletHalf;                   // world units
+uniform usampler2D uBoard;
+out vec4 FragColor;
+
+uint board_at(ivec2 t) {
+    ivec2 size = textureSize(uBoard, 0);
+    if (any(lessThan(t, ivec2(0))) || any(greaterThanEqual(t, size))) return 0u;
+    return texelFetch(uBoard, t, 0).r;
+}
+
+void main() {
+    vec2 ndc = gl_FragCoord.xy / uViewport * 2.0 - 1.0;
+    vec2 cell = (uCamera.xy + ndc / uCamera.zw - uLattice.xy) / uLattice.z;
+    int sub = int(uLattice.w);
+    if ((board_at(ivec2(floor(cell * uLattice.w))) & 1u) != 0u) {
+        FragColor = vec4(0.0, 0.0, 1.0, 1.0);
+        return;
+    }
+    ivec2 c = ivec2(floor(cell));
+    if ((board_at(c * sub + sub / 2) & 2u) != 0u) {
+        // the world shader's window-space circle around the cell centre
+        vec2 centre = uLattice.xy + (vec2(c) + 0.5) * uLattice.z;
+        vec2 pc = ((centre - uCamera.xy) * uCamera.zw * 0.5 + 0.5) * uViewport;
+        vec2 ph = uPelletHalf * uCamera.zw * 0.5 * uViewport;
+        vec2 q = (gl_FragCoord.xy - pc) / ph;
+        if (dot(q, q) <= 1.0) {
+            FragColor = vec4(1.0, 1.0, 0.0, 1.0);
+            return;
+        }
+    }
+    discard;
+}
@@ -0,0 +1,6 @@
+#version 330 core
+// Tile board, vertex stage: the unit quad stretched over the whole viewport.
+layout(location = 0) in vec2 aPos;
+void main() {
+    gl_Position = vec4(aPos * 2.0, 0.0, 1.0);
+}
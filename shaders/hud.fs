@@ -0,0 +1,10 @@
+#version 330 core
+// HUD text, fragment stage: keep the font pixels, drop the background.
+in vec2 vTexel;
+flat in vec3 vColor;
+uniform sampler2D uFont;                    // R8 glyph atlas
+out vec4 FragColor;
+void main() {
+    if (texelFetch(uFont, ivec2(vTexel), 0).r < 0.5) discard;
+    FragColor = vec4(vColor, 1.0);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+// HUD text, vertex stage: one instance per character cell.
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec4 aRect;         // top-left x, y and size w, h in pixels, y down
+layout(location = 2) in vec4 aStyle;        // rgb, glyph index in the atlas
+uniform vec2 uViewport;
+out vec2 vTexel;                            // font pixels within the atlas
+flat out vec3 vColor;
+const int ATLAS_COLS = 16;
+const vec2 CELL = vec2(6.0, 8.0);
+void main() {
+    vec2 local = aPos + 0.5;                // 0..1 across the cell, y down
+    local.y = 1.0 - local.y;
+    int glyph = int(aStyle.a);
+    vTexel = (vec2(glyph % ATLAS_COLS, glyph / ATLAS_COLS) + local) * CELL;
+    vColor = aStyle.rgb;
+    vec2 px = aRect.xy + local * aRect.zw;
+    gl_Position = vec4(px.x / uViewport.x * 2.0 - 1.0, 1.0 - px.y / uViewport.y * 2.0, 0.0, 1.0);
+}
@@ -0,0 +1,39 @@
+#version 330 core
+// Spectator wall, vertex stage: the world shader's instances for many games at
+// once, each placed in its game's tile of the atlas. Pairs with basic.fs.
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec4 aXform;        // centre.xy, extents.xy (world units)
+layout(location = 2) in vec4 aStyle;        // rgb, shape id
+layout(location = 3) in vec2 aRef;          // game index, pellet alive bit (-1 = none)
+uniform vec2 uAtlas;                        // atlas size, pixels
+uniform samplerBuffer uViews;               // per game: camera (centre.xy, 1 / half.xy), tile (x, y, w, h)
+uniform usamplerBuffer uPelletAlive;        // alive bits of every game, back to back
+out vec3 vColor;
+flat out int vShape;
+flat out vec2 vCenter;                      // atlas-space centre, pixels
+flat out vec2 vHalf;                        // atlas-space half extents
+out float gl_ClipDistance[4];
+void main() {
+    int bit = int(aRef.y);
+    if (bit >= 0 && ((texelFetch(uPelletAlive, bit >> 3).r >> uint(bit & 7)) & 1u) == 0u) {
+        for (int i = 0; i < 4; ++i) gl_ClipDistance[i] = -1.0;   // eaten
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    int game = int(aRef.x);
+    vec4 cam = texelFetch(uViews, game * 2);
+    vec4 tile = texelFetch(uViews, game * 2 + 1);
+    vec2 c = (aXform.xy - cam.xy) * cam.zw;   // NDC of the game's own view
+    vec2 e = aXform.zw * cam.zw;
+    vec2 p = aPos * e + c;
+    vColor = aStyle.rgb;
+    vShape = int(aStyle.a);
+    vCenter = tile.xy + (c * 0.5 + 0.5) * tile.zw;
+    vHalf = e * 0.25 * tile.zw;
+    // the view's edges, so nothing spills into a neighbouring tile
+    gl_ClipDistance[0] = p.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - p.x;
+    gl_ClipDistance[2] = p.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - p.y;
+    gl_Position = vec4((tile.xy + (p * 0.5 + 0.5) * tile.zw) / uAtlas * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+// Actor sprites, fragment stage: alpha 1 texels are tinted, alpha 0.5 keep
+// their colour, alpha 0 are cut out.
+in vec3 vTexel;
+flat in vec3 vTint;
+uniform sampler2DArray uSprites;
+out vec4 FragColor;
+void main() {
+    vec4 t = texture(uSprites, vTexel);
+    if (t.a < 0.25) discard;
+    FragColor = vec4(t.a > 0.75 ? t.rgb * vTint : t.rgb, 1.0);
+}
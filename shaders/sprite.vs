@@ -0,0 +1,15 @@
+#version 330 core
+// Actor sprites, vertex stage: one instance per actor, placed like the world
+// shader's instances.
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec4 aXform;        // centre.xy, extents.xy (world units)
+layout(location = 2) in vec4 aStyle;        // tint rgb, texture array layer
+uniform vec4 uCamera;                       // view centre.xy, 1 / view half extents.xy
+out vec3 vTexel;                            // uv, layer
+flat out vec3 vTint;
+void main() {
+    vec2 p = (aXform.xy + aPos * aXform.zw - uCamera.xy) * uCamera.zw;
+    vTexel = vec3(aPos + 0.5, aStyle.a);
+    vTint = aStyle.rgb;
+    gl_Position = vec4(p, 0.0, 1.0);
+}
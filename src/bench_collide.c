@@ -0,0 +1,162 @@
+// src/bench_collide.c
+// Collision kernel microbenchmark: one actor box against runs of wall boxes,
+// with every kernel collide.h has on this CPU plus the per-pair test sim.c
+// used before walls were kept as precomputed boxes. Prints the time per
+// wall tested and the speedup over that old test; all of them must agree on
+// every answer.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "collide.h"
+#include "sim.h"
+
+typedef struct {
+    float x, y;
+} Query;
+
+static unsigned rng = 0x9E3779B9u;
+
+static float frand(float lo, float hi)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return lo + (hi - lo) * (float)(rng & 0xFFFFFF) / (float)0x1000000;
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* sim.c's test before the boxes: scales both stored halves on every pair */
+static int rects_overlap_with_scales(float ax, float ay, float aStoredHalfX, float aStoredHalfY,
+                                     float bx, float by, float bStoredHalfX, float bStoredHalfY,
+                                     float aScaleX, float aScaleY, float bScaleX, float bScaleY)
+{
+    float aVisHalfX = aStoredHalfX * aScaleX * 0.5f;
+    float aVisHalfY = aStoredHalfY * aScaleY * 0.5f;
+    float bVisHalfX = bStoredHalfX * bScaleX * 0.5f;
+    float bVisHalfY = bStoredHalfY * bScaleY * 0.5f;
+
+    return (fabsf(ax - bx) < (aVisHalfX + bVisHalfX)) &&
+           (fabsf(ay - by) < (aVisHalfY + bVisHalfY));
+}
+
+static long long run_rects(const Rect *walls, int wall_count, const Query *q, int query_count,
+                           int run, float half)
+{
+    long long hits = 0;
+    for (int j = 0; j < query_count; ++j) {
+        int first = (int)(((long long)j * run) % (wall_count - run + 1));
+        for (int i = first; i < first + run; ++i) {
+            const Rect *w = &walls[i];
+            if (rects_overlap_with_scales(q[j].x, q[j].y, half, half, w->x, w->y, w->halfW, w->halfH,
+                                          PLAYER_SCALE_X, PLAYER_SCALE_Y, WALL_SCALE_X, WALL_SCALE_Y)) {
+                hits++;
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+static long long run_boxes(const CollideBoxes *boxes, const Query *q, int query_count, int run, float half)
+{
+    float hx = half * PLAYER_SCALE_X * 0.5f, hy = half * PLAYER_SCALE_Y * 0.5f;
+    long long hits = 0;
+    for (int j = 0; j < query_count; ++j) {
+        int first = (int)(((long long)j * run) % (boxes->count - run + 1));
+        hits += collide_any(boxes, first, first + run, q[j].x, q[j].y, hx, hy);
+    }
+    return hits;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--walls N] [--run N] [--queries N] [--reps N]\n"
+            "  each query tests one player-sized box against a run of N walls,\n"
+            "  stopping at the first overlap\n",
+            argv0);
+}
+
+int main(int argc, char **argv)
+{
+    int wall_count = 4096, run = 64, query_count = 100000, reps = 20;
+    for (int i = 1; i < argc; ++i) {
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return EXIT_FAILURE; }
+        if (strcmp(argv[i], "--walls") == 0) wall_count = atoi(v);
+        else if (strcmp(argv[i], "--run") == 0) run = atoi(v);
+        else if (strcmp(argv[i], "--queries") == 0) query_count = atoi(v);
+        else if (strcmp(argv[i], "--reps") == 0) reps = atoi(v);
+        else { usage(argv[0]); return EXIT_FAILURE; }
+        i++;
+    }
+    if (wall_count <= 0 || run <= 0 || run > wall_count || query_count <= 0 || reps <= 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* thin walls of the classic level's sizes scattered over a large board,
+       so most runs are tested to the end */
+    const float half = 0.05f, board = 64.0f;
+    Rect *walls = (Rect*)malloc(sizeof(Rect) * wall_count);
+    Query *queries = (Query*)malloc(sizeof(Query) * query_count);
+    CollideBoxes boxes;
+    collide_boxes_init(&boxes);
+    if (!walls || !queries || !collide_boxes_resize(&boxes, wall_count)) {
+        fprintf(stderr, "out of memory\n");
+        free(walls);
+        free(queries);
+        collide_boxes_free(&boxes);
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < wall_count; ++i) {
+        int vertical = i & 1;
+        float length = frand(0.1f, 1.0f), thick = 0.02f;
+        walls[i] = sim_wall_from_box(frand(0.0f, board), frand(0.0f, board),
+                                     vertical ? thick : length, vertical ? length : thick);
+        collide_boxes_set(&boxes, i, walls[i].x, walls[i].y,
+                          walls[i].halfW * WALL_SCALE_X * 0.5f, walls[i].halfH * WALL_SCALE_Y * 0.5f);
+    }
+    for (int j = 0; j < query_count; ++j) {
+        queries[j].x = frand(0.0f, board);
+        queries[j].y = frand(0.0f, board);
+    }
+
+    double tests = (double)query_count * run * reps;
+    printf("%d walls, runs of %d, %d queries x %d reps\n", wall_count, run, query_count, reps);
+
+    long long expect = 0;
+    double start = seconds();
+    for (int r = 0; r < reps; ++r) expect = run_rects(walls, wall_count, queries, query_count, run, half);
+    double base = seconds() - start;
+    printf("%-8s %7.3f ns/wall  %5.2fx  %lld hits\n", "rects", base * 1e9 / tests, 1.0, expect);
+
+    int ok = 1;
+    for (int k = 0; k < COLLIDE_KERNELS; ++k) {
+        if (!collide_boxes_use_kernel(&boxes, (CollideKernel)k)) {
+            printf("%-8s not supported here\n", collide_kernel_name((CollideKernel)k));
+            continue;
+        }
+        long long hits = 0;
+        start = seconds();
+        for (int r = 0; r < reps; ++r) hits = run_boxes(&boxes, queries, query_count, run, half);
+        double t = seconds() - start;
+        printf("%-8s %7.3f ns/wall  %5.2fx  %lld hits%s\n", collide_kernel_name((CollideKernel)k),
+               t * 1e9 / tests, base / t, hits, hits == expect ? "" : "  MISMATCH");
+        ok = ok && hits == expect;
+    }
+
+    free(walls);
+    free(queries);
+    collide_boxes_free(&boxes);
+    return ok ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,151 @@
+// src/board.c
+#include "board.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int board_init(Board *b, GLuint program)
+{
+    memset(b, 0, sizeof(*b));
+    if (!program) return 0;
+    b->program = program;
+    b->loc_uViewport = glGetUniformLocation(program, "uViewport");
+    b->loc_uCamera = glGetUniformLocation(program, "uCamera");
+    b->loc_uLattice = glGetUniformLocation(program, "uLattice");
+    b->loc_uPelletHalf = glGetUniformLocation(program, "uPelletHalf");
+    b->loc_uBoard = glGetUniformLocation(program, "uBoard");
+
+    glGenTextures(1, &b->tex);
+    glBindTexture(GL_TEXTURE_2D, b->tex);
+    /* integer textures only support nearest sampling; texelFetch ignores it anyway */
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return b->tex != 0;
+}
+
+void board_shutdown(Board *b)
+{
+    if (b->tex) glDeleteTextures(1, &b->tex);
+    free(b->texels);
+    memset(b, 0, sizeof(*b));
+}
+
+/* texel index along one axis whose centre is the first at or past v */
+static int first_texel(float v, float origin, float texel)
+{
+    return (int)ceilf((v - origin) / texel - 0.5f);
+}
+
+int board_build(Board *b, float min_x, float min_y, float max_x, float max_y,
+                float lattice_x, float lattice_y, float spacing,
+                const GridItem *walls, int wall_count, float pellet_hx, float pellet_hy)
+{
+    if (spacing <= 0.0f || max_x < min_x || max_y < min_y) return 0;
+
+    /* whole lattice cells from one before the level box to one after it */
+    int pad_x = (int)ceilf((lattice_x - min_x) / spacing) + 1;
+    int pad_y = (int)ceilf((lattice_y - min_y) / spacing) + 1;
+    b->origin_x = lattice_x - pad_x * spacing;
+    b->origin_y = lattice_y - pad_y * spacing;
+    int cols = (int)ceilf((max_x - b->origin_x) / spacing) + 1;
+    int rows = (int)ceilf((max_y - b->origin_y) / spacing) + 1;
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    b->sub = BOARD_SUB;
+    while (b->sub > 1 && (cols * b->sub > max_size || rows * b->sub > max_size)) b->sub /= 2;
+    if (cols > max_size || rows > max_size) {
+        fprintf(stderr, "board_build: %dx%d lattice cells exceed the %d texel texture limit\n",
+                cols, rows, (int)max_size);
+        return 0;
+    }
+
+    b->spacing = spacing;
+    b->width = cols * b->sub;
+    b->height = rows * b->sub;
+    b->pellet_hx = pellet_hx;
+    b->pellet_hy = pellet_hy;
+    free(b->texels);
+    b->texels = (unsigned char*)calloc((size_t)b->width * b->height, 1);
+    if (!b->texels) return 0;
+
+    float texel = spacing / b->sub;
+    for (int i = 0; i < wall_count; ++i) {
+        const GridItem *w = &walls[i];
+        int x0 = first_texel(w->x - w->hx, b->origin_x, texel);
+        int x1 = first_texel(w->x + w->hx, b->origin_x, texel);   /* exclusive */
+        int y0 = first_texel(w->y - w->hy, b->origin_y, texel);
+        int y1 = first_texel(w->y + w->hy, b->origin_y, texel);
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 > b->width) x1 = b->width;
+        if (y1 > b->height) y1 = b->height;
+        for (int y = y0; y < y1; ++y)
+            for (int x = x0; x < x1; ++x) b->texels[(size_t)y * b->width + x] |= BOARD_WALL;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, b->tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, b->width, b->height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return 1;
+}
+
+/* centre texel of the lattice cell holding (x, y), -1 off the board */
+static int pellet_texel(const Board *b, float x, float y)
+{
+    int cx = (int)floorf((x - b->origin_x) / b->spacing);
+    int cy = (int)floorf((y - b->origin_y) / b->spacing);
+    int tx = cx * b->sub + b->sub / 2, ty = cy * b->sub + b->sub / 2;
+    if (!b->texels || tx < 0 || ty < 0 || tx >= b->width || ty >= b->height) return -1;
+    return ty * b->width + tx;
+}
+
+void board_set_pellet(Board *b, float x, float y, int alive)
+{
+    int t = pellet_texel(b, x, y);
+    if (t < 0) return;
+    if (alive) b->texels[t] |= BOARD_PELLET;
+    else b->texels[t] &= (unsigned char)~BOARD_PELLET;
+}
+
+void board_upload(Board *b)
+{
+    if (!b->texels) return;
+    glBindTexture(GL_TEXTURE_2D, b->tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, b->width, b->height, GL_RED_INTEGER, GL_UNSIGNED_BYTE, b->texels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void board_eat_pellet(Board *b, float x, float y)
+{
+    int t = pellet_texel(b, x, y);
+    if (t < 0) return;
+    b->texels[t] &= (unsigned char)~BOARD_PELLET;
+    glBindTexture(GL_TEXTURE_2D, b->tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, t % b->width, t / b->width, 1, 1,
+                    GL_RED_INTEGER, GL_UNSIGNED_BYTE, &b->texels[t]);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void board_draw(Board *b, GLuint quad_vao, float cam_x, float cam_y,
+                float view_hx, float view_hy, int fb_width, int fb_height)
+{
+    glUseProgram(b->program);
+    glUniform2f(b->loc_uViewport, (float)fb_width, (float)fb_height);
+    glUniform4f(b->loc_uCamera, cam_x, cam_y, 1.0f / view_hx, 1.0f / view_hy);
+    glUniform4f(b->loc_uLattice, b->origin_x, b->origin_y, b->spacing, (float)b->sub);
+    glUniform2f(b->loc_uPelletHalf, b->pellet_hx, b->pellet_hy);
+    glUniform1i(b->loc_uBoard, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, b->tex);
+    glBindVertexArray(quad_vao);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,251 @@
+// src/capture.c
+#include "capture.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* BT.601 studio range, which is what Y4M players assume; planes holds 3*w*h */
+static void write_yuv444(FILE *f, const unsigned char *rgba, int w, int h, unsigned char *planes)
+{
+    size_t n = (size_t)w * h;
+    unsigned char *yp = planes, *up = planes + n, *vp = planes + 2 * n;
+    for (int y = h - 1; y >= 0; --y) {              /* GL rows are bottom-up */
+        const unsigned char *px = rgba + (size_t)y * w * 4;
+        for (int x = 0; x < w; ++x, px += 4) {
+            int r = px[0], g = px[1], b = px[2];
+            *yp++ = (unsigned char)((( 66 * r + 129 * g +  25 * b + 128) >> 8) + 16);
+            *up++ = (unsigned char)(((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+            *vp++ = (unsigned char)(((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+        }
+    }
+    fwrite(planes, 1, 3 * n, f);
+}
+
+static void *writer_main(void *arg)
+{
+    Capture *c = (Capture*)arg;
+    unsigned char *plane = (unsigned char*)malloc((size_t)c->width * c->height * 3);
+
+    pthread_mutex_lock(&c->lock);
+    for (;;) {
+        while (c->count == 0 && !c->quit) pthread_cond_wait(&c->wake, &c->lock);
+        if (c->count == 0) break;                    /* quit and drained */
+        int idx = c->queue[c->head];
+        c->head = (c->head + 1) % CAPTURE_QUEUE;
+        c->count--;
+        pthread_mutex_unlock(&c->lock);
+
+        if (plane) {
+            fputs("FRAME\n", c->file);
+            write_yuv444(c->file, c->persistent ? c->mapped[idx] : c->slots[idx],
+                         c->width, c->height, plane);
+        }
+
+        pthread_mutex_lock(&c->lock);
+        if (c->persistent) c->pbo_state[idx] = CAPTURE_PBO_FREE;
+        else c->free_slots[c->free_count++] = idx;
+        if (plane) c->stats.written++;
+    }
+    pthread_mutex_unlock(&c->lock);
+
+    free(plane);
+    return NULL;
+}
+
+static int create_pbos(Capture *c)
+{
+    GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    c->persistent = GLAD_GL_ARB_buffer_storage && glBufferStorage != NULL;
+
+    glGenBuffers(CAPTURE_PBOS, c->pbos);
+    for (int i = 0; i < CAPTURE_PBOS && c->persistent; ++i) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, c->pbos[i]);
+        glBufferStorage(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)c->frame_bytes, NULL, flags);
+        c->mapped[i] = (unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                        (GLsizeiptr)c->frame_bytes, flags);
+        if (!c->mapped[i]) {
+            /* storage is immutable, start over with plain buffers */
+            fprintf(stderr, "capture_open: persistent map failed, copying frames instead\n");
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glDeleteBuffers(CAPTURE_PBOS, c->pbos);
+            glGenBuffers(CAPTURE_PBOS, c->pbos);
+            memset(c->mapped, 0, sizeof(c->mapped));
+            c->persistent = 0;
+        }
+    }
+    if (!c->persistent) {
+        for (int i = 0; i < CAPTURE_PBOS; ++i) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, c->pbos[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)c->frame_bytes, NULL, GL_STREAM_READ);
+        }
+        for (int i = 0; i < CAPTURE_QUEUE; ++i) {
+            c->slots[i] = (unsigned char*)malloc(c->frame_bytes);
+            if (!c->slots[i]) return 0;
+            c->free_slots[c->free_count++] = i;
+        }
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return 1;
+}
+
+static void destroy_pbos(Capture *c)
+{
+    for (int i = 0; i < CAPTURE_PBOS; ++i) {
+        if (c->fences[i]) glDeleteSync(c->fences[i]);
+        c->fences[i] = 0;
+    }
+    /* deleting a buffer unmaps it */
+    glDeleteBuffers(CAPTURE_PBOS, c->pbos);
+    for (int i = 0; i < CAPTURE_QUEUE; ++i) { free(c->slots[i]); c->slots[i] = NULL; }
+}
+
+int capture_open(Capture *c, const char *path, int width, int height, int fps)
+{
+    memset(c, 0, sizeof(*c));
+    c->width = width;
+    c->height = height;
+    c->frame_bytes = (size_t)width * height * 4;
+
+    if (!create_pbos(c)) {
+        fprintf(stderr, "capture_open: out of memory\n");
+        destroy_pbos(c);
+        return 0;
+    }
+    c->file = fopen(path, "wb");
+    if (!c->file) {
+        fprintf(stderr, "capture_open: cannot open %s\n", path);
+        destroy_pbos(c);
+        return 0;
+    }
+    fprintf(c->file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, fps);
+
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->wake, NULL);
+    if (pthread_create(&c->writer, NULL, writer_main, c) != 0) {
+        fprintf(stderr, "capture_open: pthread_create failed\n");
+        pthread_mutex_destroy(&c->lock);
+        pthread_cond_destroy(&c->wake);
+        destroy_pbos(c);
+        fclose(c->file);
+        c->file = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+static void enqueue(Capture *c, int idx)
+{
+    c->queue[(c->head + c->count) % CAPTURE_QUEUE] = idx;
+    c->count++;
+    pthread_cond_signal(&c->wake);
+}
+
+/* pass a finished readback to the writer; the PBO is reusable once this returns
+   (copy path) or once the writer is done with it (persistent path) */
+static void hand_off(Capture *c, int i)
+{
+    glDeleteSync(c->fences[i]);
+    c->fences[i] = 0;
+
+    if (c->persistent) {
+        pthread_mutex_lock(&c->lock);
+        c->pbo_state[i] = CAPTURE_PBO_WRITING;
+        enqueue(c, i);
+        pthread_mutex_unlock(&c->lock);
+        return;
+    }
+
+    c->pbo_state[i] = CAPTURE_PBO_FREE;
+    pthread_mutex_lock(&c->lock);
+    int slot = c->free_count > 0 ? c->free_slots[--c->free_count] : -1;
+    pthread_mutex_unlock(&c->lock);
+    if (slot < 0) { c->stats.dropped++; return; }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, c->pbos[i]);
+    const void *src = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)c->frame_bytes, GL_MAP_READ_BIT);
+    if (src) {
+        memcpy(c->slots[slot], src, c->frame_bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    pthread_mutex_lock(&c->lock);
+    if (src) enqueue(c, slot);
+    else { c->free_slots[c->free_count++] = slot; c->stats.dropped++; }
+    pthread_mutex_unlock(&c->lock);
+}
+
+/* hand off readbacks oldest first; with block = 0 stop at the first one the
+   GPU has not finished */
+static void collect(Capture *c, int block)
+{
+    while (c->in_flight > 0) {
+        int i = (c->next - c->in_flight + CAPTURE_PBOS) % CAPTURE_PBOS;
+        GLenum r = glClientWaitSync(c->fences[i], GL_SYNC_FLUSH_COMMANDS_BIT,
+                                    block ? GL_TIMEOUT_IGNORED : 0);
+        if (r == GL_TIMEOUT_EXPIRED) break;
+        c->in_flight--;
+        hand_off(c, i);
+    }
+}
+
+void capture_frame(Capture *c, int fb_width, int fb_height)
+{
+    if (!c->file) return;
+    double t0 = seconds();
+    c->stats.frames++;
+
+    collect(c, 0);
+
+    int i = c->next;
+    pthread_mutex_lock(&c->lock);
+    int state = c->pbo_state[i];
+    pthread_mutex_unlock(&c->lock);
+    if (state == CAPTURE_PBO_READING) {
+        /* every PBO is in flight: this one is CAPTURE_PBOS frames old, so
+           waiting for it costs next to nothing */
+        collect(c, 1);
+        pthread_mutex_lock(&c->lock);
+        state = c->pbo_state[i];
+        pthread_mutex_unlock(&c->lock);
+    }
+
+    if (fb_width != c->width || fb_height != c->height || state != CAPTURE_PBO_FREE) {
+        c->stats.dropped++;
+    } else {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, c->pbos[i]);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, c->width, c->height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        c->fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        c->pbo_state[i] = CAPTURE_PBO_READING;
+        c->next = (i + 1) % CAPTURE_PBOS;
+        c->in_flight++;
+    }
+
+    c->stats.main_seconds += seconds() - t0;
+}
+
+void capture_close(Capture *c)
+{
+    if (!c->file) return;
+
+    collect(c, 1);
+
+    pthread_mutex_lock(&c->lock);
+    c->quit = 1;
+    pthread_cond_signal(&c->wake);
+    pthread_mutex_unlock(&c->lock);
+    pthread_join(c->writer, NULL);
+
+    destroy_pbos(c);
+    pthread_mutex_destroy(&c->lock);
+    pthread_cond_destroy(&c->wake);
+    fclose(c->file);
+    c->file = NULL;
+}
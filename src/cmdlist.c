@@ -0,0 +1,195 @@
+// src/cmdlist.c
+#include "cmdlist.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Sort key, most significant first:
+     layer 8 | program 10 | vao 10 | texture 10 | tint 12 | sequence 14
+   GL names are folded into 10 bits; a collision only costs a missed grouping,
+   merging and binding always compare the real fields. The sequence keeps the
+   sort stable so commands within one state group stay in submission order. */
+#define CMD_SEQ_BITS 14
+#define CMD_MAX_COMMANDS (1 << CMD_SEQ_BITS)
+
+/* state a naive replay binds per command: program, VAO, texture, tint */
+#define CMD_NAIVE_BINDS_PER_CMD 4
+
+static unsigned quantize_tint(const float t[3])
+{
+    unsigned q = 0;
+    for (int i = 0; i < 3; ++i) {
+        float v = t[i] < 0.0f ? 0.0f : (t[i] > 1.0f ? 1.0f : t[i]);
+        q = (q << 4) | (unsigned)(v * 15.0f + 0.5f);
+    }
+    return q;
+}
+
+static uint64_t make_key(const RenderCmd *c, int seq)
+{
+    uint64_t k = c->layer;
+    k = (k << 10) | (c->program & 0x3FFu);
+    k = (k << 10) | (c->vao & 0x3FFu);
+    k = (k << 10) | (c->texture & 0x3FFu);
+    k = (k << 12) | quantize_tint(c->tint);
+    k = (k << CMD_SEQ_BITS) | (uint64_t)seq;
+    return k;
+}
+
+int cmdlist_init(CmdList *l, int capacity)
+{
+    if (!l || capacity <= 0) return 0;
+    if (capacity > CMD_MAX_COMMANDS) capacity = CMD_MAX_COMMANDS;
+    l->cmds = (RenderCmd*)malloc(sizeof(RenderCmd) * capacity);
+    l->scratch = (RenderCmd*)malloc(sizeof(RenderCmd) * capacity);
+    if (!l->cmds || !l->scratch) {
+        free(l->cmds); free(l->scratch);
+        l->cmds = l->scratch = NULL;
+        return 0;
+    }
+    l->capacity = capacity;
+    l->count = 0;
+    memset(&l->stats, 0, sizeof(l->stats));
+    return 1;
+}
+
+void cmdlist_shutdown(CmdList *l)
+{
+    if (!l) return;
+    free(l->cmds); l->cmds = NULL;
+    free(l->scratch); l->scratch = NULL;
+    l->count = l->capacity = 0;
+}
+
+void cmdlist_reset(CmdList *l)
+{
+    l->count = 0;
+}
+
+int cmdlist_push(CmdList *l, const RenderCmd *cmd)
+{
+    if (l->count >= l->capacity || cmd->instance_count <= 0) return 0;
+    RenderCmd *c = &l->cmds[l->count];
+    *c = *cmd;
+    c->key = make_key(cmd, l->count);
+    l->count++;
+    return 1;
+}
+
+/* LSD radix sort on the 64-bit key, one byte per pass; passes where every key
+   has the same byte are skipped, which is most of them in practice */
+static void sort_commands(CmdList *l)
+{
+    RenderCmd *src = l->cmds, *dst = l->scratch;
+    int n = l->count;
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        int hist[256] = {0};
+        for (int i = 0; i < n; ++i) hist[(src[i].key >> shift) & 0xFF]++;
+        if (hist[(src[0].key >> shift) & 0xFF] == n) continue;
+
+        int sum = 0;
+        for (int b = 0; b < 256; ++b) { int c = hist[b]; hist[b] = sum; sum += c; }
+        for (int i = 0; i < n; ++i) dst[hist[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+        RenderCmd *t = src; src = dst; dst = t;
+    }
+    if (src != l->cmds) memcpy(l->cmds, src, sizeof(RenderCmd) * n);
+}
+
+static int same_state(const RenderCmd *a, const RenderCmd *b)
+{
+    return a->program == b->program && a->vao == b->vao &&
+           a->texture == b->texture && a->texture_target == b->texture_target &&
+           a->tint_loc == b->tint_loc && a->base_loc == b->base_loc &&
+           a->layout == b->layout && a->index_count == b->index_count &&
+           a->tint[0] == b->tint[0] && a->tint[1] == b->tint[1] && a->tint[2] == b->tint[2];
+}
+
+static void point_instances(CmdInstanceLayout *layout, int first)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, layout->buffer);
+    for (int a = 0; a < layout->attrib_count; ++a) {
+        GLintptr off = (GLintptr)first * layout->stride + layout->attribs[a].offset;
+        glVertexAttribPointer(layout->attribs[a].index, layout->attribs[a].size, GL_FLOAT, GL_FALSE,
+                              layout->stride, (void*)off);
+    }
+    layout->bound_first = first;
+}
+
+void cmdlist_submit(CmdList *l)
+{
+    CmdListStats *st = &l->stats;
+    memset(st, 0, sizeof(*st));
+    st->commands = l->count;
+    if (l->count == 0) return;
+
+    sort_commands(l);
+
+    GLuint cur_program = 0, cur_vao = 0, cur_tex = 0;
+    GLenum cur_target = 0;
+    int have_program = 0, have_vao = 0, have_tint = 0, have_base = 0;
+    float cur_tint[3] = {0};
+    int cur_base = 0;
+
+    for (int i = 0; i < l->count; ++i) {
+        const RenderCmd *c = &l->cmds[i];
+        int first = c->first_instance;
+        int count = c->instance_count;
+
+        /* fold following commands that continue this instance range */
+        while (i + 1 < l->count && same_state(c, &l->cmds[i + 1]) &&
+               l->cmds[i + 1].first_instance == first + count) {
+            count += l->cmds[i + 1].instance_count;
+            st->merged++;
+            i++;
+        }
+
+        if (!have_program || c->program != cur_program) {
+            glUseProgram(c->program);
+            cur_program = c->program;
+            have_program = 1;
+            have_tint = have_base = 0;   /* uniforms are per program */
+            st->state_changes++;
+        }
+        if (!have_vao || c->vao != cur_vao) {
+            glBindVertexArray(c->vao);
+            cur_vao = c->vao;
+            have_vao = 1;
+            st->state_changes++;
+        }
+        if (c->texture && (c->texture != cur_tex || c->texture_target != cur_target)) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(c->texture_target, c->texture);
+            cur_tex = c->texture;
+            cur_target = c->texture_target;
+            st->state_changes++;
+        }
+        if (c->tint_loc >= 0 && (!have_tint || memcmp(cur_tint, c->tint, sizeof(cur_tint)) != 0)) {
+            glUniform3fv(c->tint_loc, 1, c->tint);
+            memcpy(cur_tint, c->tint, sizeof(cur_tint));
+            have_tint = 1;
+            st->state_changes++;
+        }
+
+        int base = 0;
+        if (c->layout) {
+            if (c->layout->bound_first != first) {
+                point_instances(c->layout, first);
+                st->state_changes++;
+            }
+            base = first;
+        }
+        if (c->base_loc >= 0 && (!have_base || cur_base != base)) {
+            glUniform1i(c->base_loc, base);
+            cur_base = base;
+            have_base = 1;
+            st->state_changes++;
+        }
+
+        glDrawElementsInstanced(GL_TRIANGLES, c->index_count, GL_UNSIGNED_INT, 0, count);
+        st->draws++;
+    }
+
+    int naive = st->commands * CMD_NAIVE_BINDS_PER_CMD;
+    st->redundant_skipped = naive > st->state_changes ? naive - st->state_changes : 0;
+}
@@ -0,0 +1,175 @@
+// src/collide.c
+#include "collide.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* GCC and clang build the SSE2 and AVX2 kernels whatever -m flags the file
+   gets, through target attributes, and ask the CPU at run time which to use.
+   MSVC x64 always has SSE2; anything else gets the scalar loop. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define COLLIDE_HAVE_SSE2 1
+#define COLLIDE_HAVE_AVX2 1
+#define COLLIDE_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_M_X64)
+#include <emmintrin.h>
+#define COLLIDE_HAVE_SSE2 1
+#define COLLIDE_TARGET(isa)
+#endif
+
+typedef int (*CollideFn)(const CollideBoxes *b, int first, int end, float x, float y, float hx, float hy);
+
+/* the one test every kernel repeats lane by lane: |dx| < hx + box hx, same for y */
+static inline int hit(const CollideBoxes *b, int i, float x, float y, float hx, float hy)
+{
+    return (fabsf(x - b->x[i]) < hx + b->hx[i]) & (fabsf(y - b->y[i]) < hy + b->hy[i]);
+}
+
+static int any_scalar(const CollideBoxes *b, int first, int end, float x, float y, float hx, float hy)
+{
+    for (int i = first; i < end; ++i)
+        if (hit(b, i, x, y, hx, hy)) return 1;
+    return 0;
+}
+
+#ifdef COLLIDE_HAVE_SSE2
+COLLIDE_TARGET("sse2")
+static int any_sse2(const CollideBoxes *b, int first, int end, float x, float y, float hx, float hy)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 px = _mm_set1_ps(x), py = _mm_set1_ps(y);
+    const __m128 phx = _mm_set1_ps(hx), phy = _mm_set1_ps(hy);
+    int i = first;
+    for (; i + 4 <= end; i += 4) {
+        __m128 dx = _mm_andnot_ps(sign, _mm_sub_ps(px, _mm_loadu_ps(b->x + i)));
+        __m128 dy = _mm_andnot_ps(sign, _mm_sub_ps(py, _mm_loadu_ps(b->y + i)));
+        __m128 in = _mm_and_ps(_mm_cmplt_ps(dx, _mm_add_ps(phx, _mm_loadu_ps(b->hx + i))),
+                               _mm_cmplt_ps(dy, _mm_add_ps(phy, _mm_loadu_ps(b->hy + i))));
+        if (_mm_movemask_ps(in)) return 1;
+    }
+    for (; i < end; ++i)
+        if (hit(b, i, x, y, hx, hy)) return 1;
+    return 0;
+}
+#endif
+
+#ifdef COLLIDE_HAVE_AVX2
+COLLIDE_TARGET("avx2")
+static int any_avx2(const CollideBoxes *b, int first, int end, float x, float y, float hx, float hy)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 px = _mm256_set1_ps(x), py = _mm256_set1_ps(y);
+    const __m256 phx = _mm256_set1_ps(hx), phy = _mm256_set1_ps(hy);
+    int i = first;
+    for (; i + 8 <= end; i += 8) {
+        __m256 dx = _mm256_andnot_ps(sign, _mm256_sub_ps(px, _mm256_loadu_ps(b->x + i)));
+        __m256 dy = _mm256_andnot_ps(sign, _mm256_sub_ps(py, _mm256_loadu_ps(b->y + i)));
+        __m256 in = _mm256_and_ps(_mm256_cmp_ps(dx, _mm256_add_ps(phx, _mm256_loadu_ps(b->hx + i)), _CMP_LT_OQ),
+                                  _mm256_cmp_ps(dy, _mm256_add_ps(phy, _mm256_loadu_ps(b->hy + i)), _CMP_LT_OQ));
+        if (_mm256_movemask_ps(in)) return 1;
+    }
+    /* the tail stays in this function: a call out with the upper halves of
+       the ymm registers dirty would slow every SSE instruction after it */
+    for (; i < end; ++i)
+        if (hit(b, i, x, y, hx, hy)) return 1;
+    return 0;
+}
+#endif
+
+static const CollideFn kernels[COLLIDE_KERNELS] = {
+    any_scalar,
+#ifdef COLLIDE_HAVE_SSE2
+    any_sse2,
+#else
+    NULL,
+#endif
+#ifdef COLLIDE_HAVE_AVX2
+    any_avx2,
+#else
+    NULL,
+#endif
+};
+
+static const char *const kernel_names[COLLIDE_KERNELS] = { "scalar", "sse2", "avx2" };
+
+static int cpu_has(CollideKernel k)
+{
+    if (k < 0 || k >= COLLIDE_KERNELS || !kernels[k]) return 0;
+#ifdef COLLIDE_HAVE_AVX2
+    /* GCC / clang on x86: the kernels exist, the CPU may still lack them. The
+       runtime fills in the CPU model before main, so this only reads it. */
+    if (k == COLLIDE_SSE2) return __builtin_cpu_supports("sse2");
+    if (k == COLLIDE_AVX2) return __builtin_cpu_supports("avx2");
+#endif
+    return 1;
+}
+
+void collide_boxes_init(CollideBoxes *b)
+{
+    memset(b, 0, sizeof(*b));
+    b->kernel = collide_best_kernel();
+}
+
+int collide_boxes_resize(CollideBoxes *b, int count)
+{
+    if (count < 0) return 0;
+    if (count > b->capacity) {
+        int cap = b->capacity ? b->capacity : 64;
+        while (cap < count) cap *= 2;
+        float *arrays[4] = { b->x, b->y, b->hx, b->hy };
+        for (int a = 0; a < 4; ++a) {
+            float *p = (float*)realloc(arrays[a], sizeof(float) * (size_t)cap);
+            if (!p) {
+                /* keep what did grow; capacity stays the old, smaller one */
+                b->x = arrays[0]; b->y = arrays[1]; b->hx = arrays[2]; b->hy = arrays[3];
+                return 0;
+            }
+            arrays[a] = p;
+        }
+        b->x = arrays[0]; b->y = arrays[1]; b->hx = arrays[2]; b->hy = arrays[3];
+        b->capacity = cap;
+    }
+    b->count = count;
+    return 1;
+}
+
+void collide_boxes_free(CollideBoxes *b)
+{
+    free(b->x);
+    free(b->y);
+    free(b->hx);
+    free(b->hy);
+    CollideKernel kernel = b->kernel;
+    memset(b, 0, sizeof(*b));
+    b->kernel = kernel;
+}
+
+void collide_boxes_set(CollideBoxes *b, int i, float x, float y, float hx, float hy)
+{
+    b->x[i] = x; b->y[i] = y; b->hx[i] = hx; b->hy[i] = hy;
+}
+
+int collide_any(const CollideBoxes *b, int first, int end, float x, float y, float hx, float hy)
+{
+    return kernels[b->kernel](b, first, end, x, y, hx, hy);
+}
+
+CollideKernel collide_best_kernel(void)
+{
+    for (int k = COLLIDE_KERNELS - 1; k > 0; --k)
+        if (cpu_has((CollideKernel)k)) return (CollideKernel)k;
+    return COLLIDE_SCALAR;
+}
+
+int collide_boxes_use_kernel(CollideBoxes *b, CollideKernel k)
+{
+    if (!cpu_has(k)) return 0;
+    b->kernel = k;
+    return 1;
+}
+
+const char *collide_kernel_name(CollideKernel k)
+{
+    return k >= 0 && k < COLLIDE_KERNELS ? kernel_names[k] : "?";
+}
@@ -0,0 +1,178 @@
+// src/damage.c
+#include "damage.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* pixels added around every box: covers rasterization at the edges */
+#define DAMAGE_PAD 2
+
+static void destroy_target(Damage *d)
+{
+    if (d->fbo) glDeleteFramebuffers(1, &d->fbo);
+    if (d->color_rb) glDeleteRenderbuffers(1, &d->color_rb);
+    d->fbo = d->color_rb = 0;
+}
+
+static int create_target(Damage *d, int width, int height)
+{
+    glGenRenderbuffers(1, &d->color_rb);
+    glBindRenderbuffer(GL_RENDERBUFFER, d->color_rb);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenFramebuffers(1, &d->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, d->fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, d->color_rb);
+    int ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!ok) {
+        fprintf(stderr, "damage: scene framebuffer incomplete\n");
+        destroy_target(d);
+        return 0;
+    }
+    d->width = width;
+    d->height = height;
+    d->full = 1;
+    return 1;
+}
+
+int damage_init(Damage *d, int width, int height)
+{
+    memset(d, 0, sizeof(*d));
+    return create_target(d, width, height);
+}
+
+void damage_shutdown(Damage *d)
+{
+    destroy_target(d);
+}
+
+int damage_resize(Damage *d, int width, int height)
+{
+    if (width == d->width && height == d->height && d->fbo) return 1;
+    destroy_target(d);
+    if (width <= 0 || height <= 0) return 0;   /* minimized */
+    return create_target(d, width, height);
+}
+
+void damage_all(Damage *d)
+{
+    d->full = 1;
+}
+
+static int rect_area(const DamageRect *r)
+{
+    return (r->x1 - r->x0) * (r->y1 - r->y0);
+}
+
+static DamageRect rect_union(const DamageRect *a, const DamageRect *b)
+{
+    DamageRect u;
+    u.x0 = a->x0 < b->x0 ? a->x0 : b->x0;
+    u.y0 = a->y0 < b->y0 ? a->y0 : b->y0;
+    u.x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+    u.y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+    return u;
+}
+
+/* adds r and keeps the list disjoint: r swallows every region it overlaps;
+   with the list full it joins the region it grows least instead */
+static void add_rect(Damage *d, DamageRect r)
+{
+    for (int i = 0; i < d->count;) {
+        const DamageRect *o = &d->rects[i];
+        if (r.x0 < o->x1 && o->x0 < r.x1 && r.y0 < o->y1 && o->y0 < r.y1) {
+            r = rect_union(&r, o);
+            d->rects[i] = d->rects[--d->count];
+            i = 0;   /* the union may reach regions already passed */
+        } else {
+            i++;
+        }
+    }
+    if (d->count == DAMAGE_MAX_RECTS) {
+        int best = 0, best_growth = 0;
+        for (int i = 0; i < d->count; ++i) {
+            DamageRect u = rect_union(&r, &d->rects[i]);
+            int growth = rect_area(&u) - rect_area(&d->rects[i]);
+            if (i == 0 || growth < best_growth) { best = i; best_growth = growth; }
+        }
+        r = rect_union(&r, &d->rects[best]);
+        d->rects[best] = d->rects[--d->count];
+        add_rect(d, r);
+        return;
+    }
+    d->rects[d->count++] = r;
+}
+
+void damage_add_box(Damage *d, float cx, float cy, float hx, float hy)
+{
+    /* NDC -> window pixels, rounded outwards */
+    DamageRect r;
+    r.x0 = (int)floorf((cx - hx) * 0.5f * d->width + 0.5f * d->width) - DAMAGE_PAD;
+    r.x1 = (int)ceilf((cx + hx) * 0.5f * d->width + 0.5f * d->width) + DAMAGE_PAD;
+    r.y0 = (int)floorf((cy - hy) * 0.5f * d->height + 0.5f * d->height) - DAMAGE_PAD;
+    r.y1 = (int)ceilf((cy + hy) * 0.5f * d->height + 0.5f * d->height) + DAMAGE_PAD;
+    if (r.x0 < 0) r.x0 = 0;
+    if (r.y0 < 0) r.y0 = 0;
+    if (r.x1 > d->width) r.x1 = d->width;
+    if (r.y1 > d->height) r.y1 = d->height;
+    if (r.x0 >= r.x1 || r.y0 >= r.y1) return;
+    add_rect(d, r);
+}
+
+int damage_begin(Damage *d)
+{
+    d->stats.frames++;
+    if (!d->fbo || (!d->full && !d->count)) {
+        d->stats.idle++;
+        return 0;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, d->fbo);
+    glViewport(0, 0, d->width, d->height);
+    if (d->full) {
+        d->stats.full++;
+        d->stats.pixels += (double)d->width * d->height;
+        glClear(GL_COLOR_BUFFER_BIT);
+        return 1;
+    }
+    /* the regions are disjoint, so their areas add up */
+    d->stats.partial++;
+    d->stats.regions += (unsigned long long)d->count;
+    for (int i = 0; damage_region(d, i); ++i) {
+        d->stats.pixels += (double)rect_area(&d->rects[i]);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    return 1;
+}
+
+int damage_region(Damage *d, int i)
+{
+    if (d->full) {
+        if (i > 0) return 0;
+        glDisable(GL_SCISSOR_TEST);
+        return 1;
+    }
+    if (i >= d->count) return 0;
+    const DamageRect *r = &d->rects[i];
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0);
+    return 1;
+}
+
+void damage_end(Damage *d)
+{
+    glDisable(GL_SCISSOR_TEST);
+    d->full = 0;
+    d->count = 0;
+}
+
+void damage_blit(Damage *d, int dst_width, int dst_height)
+{
+    if (!d->fbo) return;
+    int same = dst_width == d->width && dst_height == d->height;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, d->fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, d->width, d->height, 0, 0, dst_width, dst_height,
+                      GL_COLOR_BUFFER_BIT, same ? GL_NEAREST : GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
@@ -0,0 +1,65 @@
+// src/dynres.c
+#include "dynres.h"
+#include <math.h>
+#include <string.h>
+
+/* weight of a new sample in the smoothed frame time */
+#define DYNRES_SMOOTHING 0.1f
+
+static float clamp_scale(const DynRes *r, float s)
+{
+    s = floorf(s / DYNRES_STEP + 0.5f) * DYNRES_STEP;
+    if (s < r->min_scale) s = r->min_scale;
+    if (s > r->max_scale) s = r->max_scale;
+    return s;
+}
+
+void dynres_init(DynRes *r, float target_ms, float min_scale, float max_scale)
+{
+    memset(r, 0, sizeof(*r));
+    if (max_scale > 1.0f || max_scale <= 0.0f) max_scale = 1.0f;
+    if (min_scale > max_scale) min_scale = max_scale;
+    if (min_scale < DYNRES_STEP) min_scale = DYNRES_STEP;
+    r->target_ms = target_ms;
+    r->min_scale = min_scale;
+    r->max_scale = max_scale;
+    r->scale = max_scale;
+}
+
+int dynres_update(DynRes *r, float frame_ms)
+{
+    if (frame_ms <= 0.0f || r->target_ms <= 0.0f) return 0;
+    if (r->smoothed_ms == 0.0f) r->smoothed_ms = frame_ms;
+    else r->smoothed_ms += (frame_ms - r->smoothed_ms) * DYNRES_SMOOTHING;
+    if (r->cooldown > 0) {
+        r->cooldown--;
+        return 0;
+    }
+
+    float next = r->scale;
+    if (r->smoothed_ms > r->target_ms) {
+        next = r->scale * sqrtf(r->target_ms / r->smoothed_ms);
+        /* round down, so a frame over budget always gives up a step */
+        if (clamp_scale(r, next) >= r->scale) next = r->scale - DYNRES_STEP;
+    } else if (r->smoothed_ms < r->target_ms * DYNRES_HEADROOM) {
+        /* aim under the target; a step at most, growing is the risky way */
+        next = r->scale * sqrtf(r->target_ms * DYNRES_HEADROOM / r->smoothed_ms);
+        if (next > r->scale + DYNRES_STEP) next = r->scale + DYNRES_STEP;
+    }
+    next = clamp_scale(r, next);
+    if (next == r->scale) return 0;
+
+    r->scale = next;
+    r->smoothed_ms = 0.0f;
+    r->cooldown = DYNRES_COOLDOWN;
+    r->changes++;
+    return 1;
+}
+
+void dynres_size(const DynRes *r, int width, int height, int *out_w, int *out_h)
+{
+    *out_w = (int)(width * r->scale + 0.5f);
+    *out_h = (int)(height * r->scale + 0.5f);
+    if (width > 0 && *out_w < 1) *out_w = 1;
+    if (height > 0 && *out_h < 1) *out_h = 1;
+}
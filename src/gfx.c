@@ -0,0 +1,324 @@
+// src/gfx.c
+#include "gfx.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+/* Program binary cache file: header, then the driver's blob. The file name
+   already carries the key; the copy in the header guards against renamed or
+   truncated files. */
+#define GFX_CACHE_MAGIC 0x42504D50u   /* "PMPB" */
+#define GFX_CACHE_VERSION 1u
+
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned long long key;
+    unsigned int format;     // binaryFormat from glGetProgramBinary
+    unsigned int length;
+} GfxCacheHeader;
+
+static char *read_text(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *text = n >= 0 ? (char*)malloc((size_t)n + 1) : NULL;
+    if (text && fread(text, 1, (size_t)n, f) != (size_t)n) { free(text); text = NULL; }
+    if (text) text[n] = '\0';
+    fclose(f);
+    return text;
+}
+
+/* FNV-1a, 64 bit */
+static unsigned long long hash_str(unsigned long long h, const char *s)
+{
+    for (; s && *s; ++s) { h ^= (unsigned char)*s; h *= 0x100000001B3ULL; }
+    return h ^ 0xFF;   /* separator, so "ab"+"c" differs from "a"+"bc" */
+}
+
+static unsigned long long program_key(const char *vs, const char *fs)
+{
+    unsigned long long h = 0xCBF29CE484222325ULL;
+    h = hash_str(h, vs);
+    h = hash_str(h, fs);
+    h = hash_str(h, (const char*)glGetString(GL_VENDOR));
+    h = hash_str(h, (const char*)glGetString(GL_RENDERER));
+    h = hash_str(h, (const char*)glGetString(GL_VERSION));
+    return h;
+}
+
+static int binary_cache_usable(void)
+{
+    if (!GLAD_GL_ARB_get_program_binary || !glGetProgramBinary || !glProgramBinary) return 0;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+static int make_dir(const char *path)
+{
+#ifdef _WIN32
+    return _mkdir(path) == 0 || errno == EEXIST;
+#else
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+const char *gfx_cache_dir(const char *option)
+{
+    static char dir[512];
+    if (option) return strcmp(option, "none") == 0 ? NULL : option;
+    if (dir[0]) return dir;
+
+#ifdef _WIN32
+    const char *base = getenv("LOCALAPPDATA");
+    if (!base || !base[0]) return NULL;
+    snprintf(dir, sizeof(dir), "%s\\pman", base);
+#else
+    const char *base = getenv("XDG_CACHE_HOME");
+    if (base && base[0]) {
+        snprintf(dir, sizeof(dir), "%s/pman", base);
+    } else {
+        const char *home = getenv("HOME");
+        if (!home || !home[0]) return NULL;
+        snprintf(dir, sizeof(dir), "%s/.cache", home);
+        if (!make_dir(dir)) { dir[0] = '\0'; return NULL; }
+        snprintf(dir, sizeof(dir), "%s/.cache/pman", home);
+    }
+#endif
+    if (!make_dir(dir)) {
+        fprintf(stderr, "shader cache: cannot create %s, not caching\n", dir);
+        dir[0] = '\0';
+        return NULL;
+    }
+    return dir;
+}
+
+/* file is <name>-<16 hex digits>.glbin, a binary of program name */
+static int is_cache_file_of(const char *file, const char *name)
+{
+    size_t n = strlen(name);
+    if (strncmp(file, name, n) != 0 || file[n] != '-') return 0;
+    for (int i = 0; i < 16; ++i)
+        if (!isxdigit((unsigned char)file[n + 1 + i])) return 0;
+    return strcmp(file + n + 17, ".glbin") == 0;
+}
+
+/* a program has one current binary; the others were built from old sources
+   or for another driver and would only pile up */
+static void prune_cached_programs(const char *dir, const char *name, const char *keep)
+{
+    char path[512];
+#ifdef _WIN32
+    struct _finddata_t fd;
+    snprintf(path, sizeof(path), "%s/%s-*.glbin", dir, name);
+    intptr_t h = _findfirst(path, &fd);
+    if (h == -1) return;
+    do {
+        if (!is_cache_file_of(fd.name, name)) continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, fd.name);
+        if (strcmp(path, keep) != 0) remove(path);
+    } while (_findnext(h, &fd) == 0);
+    _findclose(h);
+#else
+    DIR *d = opendir(dir);
+    if (!d) return;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        if (!is_cache_file_of(e->d_name, name)) continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+        if (strcmp(path, keep) != 0) remove(path);
+    }
+    closedir(d);
+#endif
+}
+
+static GLuint load_cached_program(const char *path, unsigned long long key)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    GfxCacheHeader hdr;
+    void *blob = NULL;
+    if (fread(&hdr, sizeof(hdr), 1, f) == 1 && hdr.magic == GFX_CACHE_MAGIC &&
+        hdr.version == GFX_CACHE_VERSION && hdr.key == key && hdr.length > 0) {
+        blob = malloc(hdr.length);
+        if (blob && fread(blob, 1, hdr.length, f) != hdr.length) { free(blob); blob = NULL; }
+    }
+    fclose(f);
+    if (!blob) return 0;
+
+    GLuint p = glCreateProgram();
+    glProgramBinary(p, hdr.format, blob, (GLsizei)hdr.length);
+    free(blob);
+    GLint ok = 0;
+    glGetProgramiv(p, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        /* the driver rejected it (e.g. it was updated); recompile and rewrite */
+        glDeleteProgram(p);
+        return 0;
+    }
+    return p;
+}
+
+static void store_cached_program(const char *dir, const char *name, const char *path,
+                                 unsigned long long key, GLuint program)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    void *blob = malloc((size_t)length);
+    if (!blob) return;
+
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, blob);
+    GfxCacheHeader hdr = { GFX_CACHE_MAGIC, GFX_CACHE_VERSION, key, format, (unsigned int)length };
+    FILE *f = fopen(path, "wb");
+    if (f) {
+        int ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 && fwrite(blob, 1, (size_t)length, f) == (size_t)length;
+        if (fclose(f) != 0 || !ok) {
+            fprintf(stderr, "shader cache: failed to write %s\n", path);
+            remove(path);
+        } else {
+            prune_cached_programs(dir, name, path);
+        }
+    }
+    free(blob);
+}
+
+/* Shader helpers */
+static GLuint compile_shader(GLenum type, const char *src) {
+    GLuint s = glCreateShader(type);
+    glShaderSource(s, 1, &src, NULL);
+    glCompileShader(s);
+    GLint ok = 0;
+    glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[512];
+        glGetShaderInfoLog(s, sizeof(log), NULL, log);
+        fprintf(stderr, "Shader compile error: %s\n", log);
+        glDeleteShader(s);
+        return 0;
+    }
+    return s;
+}
+
+static GLuint link_program(GLuint v, GLuint f, int retrievable) {
+    GLuint p = glCreateProgram();
+    glAttachShader(p, v);
+    glAttachShader(p, f);
+    if (retrievable) glProgramParameteri(p, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(p);
+    GLint ok = 0;
+    glGetProgramiv(p, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[512];
+        glGetProgramInfoLog(p, sizeof(log), NULL, log);
+        fprintf(stderr, "Program link error: %s\n", log);
+        glDeleteProgram(p);
+        return 0;
+    }
+    return p;
+}
+
+GLuint gfx_create_program(const char *shader_dir, const char *name, const char *cache_dir, int *from_cache)
+{
+    return gfx_create_program_pair(shader_dir, name, name, cache_dir, from_cache);
+}
+
+GLuint gfx_create_program_pair(const char *shader_dir, const char *vs_name, const char *fs_name,
+                               const char *cache_dir, int *from_cache)
+{
+    char vs_path[512], fs_path[512], cache_path[512];
+    snprintf(vs_path, sizeof(vs_path), "%s/%s.vs", shader_dir, vs_name);
+    snprintf(fs_path, sizeof(fs_path), "%s/%s.fs", shader_dir, fs_name);
+    if (from_cache) *from_cache = 0;
+
+    char *vs = read_text(vs_path);
+    char *fs = read_text(fs_path);
+    if (!vs || !fs || !vs[0] || !fs[0]) {
+        fprintf(stderr, "cannot read shaders %s and %s\n", vs_path, fs_path);
+        free(vs); free(fs);
+        return 0;
+    }
+
+    int use_cache = cache_dir && binary_cache_usable();
+    unsigned long long key = 0;
+    GLuint program = 0;
+    if (use_cache) {
+        key = program_key(vs, fs);
+        snprintf(cache_path, sizeof(cache_path), "%s/%s-%016llx.glbin", cache_dir, vs_name, key);
+        program = load_cached_program(cache_path, key);
+        if (program) {
+            if (from_cache) *from_cache = 1;
+            free(vs); free(fs);
+            return program;
+        }
+    }
+
+    GLuint vsh = compile_shader(GL_VERTEX_SHADER, vs);
+    GLuint fsh = compile_shader(GL_FRAGMENT_SHADER, fs);
+    free(vs); free(fs);
+    if (!vsh || !fsh) {
+        fprintf(stderr, "shader compile failed\n");
+        if (vsh) glDeleteShader(vsh);
+        if (fsh) glDeleteShader(fsh);
+        return 0;
+    }
+    program = link_program(vsh, fsh, use_cache);
+    glDeleteShader(vsh);
+    glDeleteShader(fsh);
+    if (!program) {
+        fprintf(stderr, "program link failed\n");
+        return 0;
+    }
+    if (use_cache) store_cached_program(cache_dir, vs_name, cache_path, key, program);
+    return program;
+}
+
+int gfx_create_quad(GfxQuad *q)
+{
+    /* Unit quad geometry (centered at origin, coordinates in [-0.5, +0.5]) */
+    float vertices[] = {
+        -0.5f, -0.5f,
+         0.5f, -0.5f,
+         0.5f,  0.5f,
+        -0.5f,  0.5f
+    };
+    unsigned int indices[] = {0,1,2, 2,3,0};
+
+    q->vao = q->vbo = q->ebo = 0;
+    glGenVertexArrays(1, &q->vao);
+    glGenBuffers(1, &q->vbo);
+    glGenBuffers(1, &q->ebo);
+    if (!q->vao || !q->vbo || !q->ebo) return 0;
+
+    glBindVertexArray(q->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, q->vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, q->ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    return 1;
+}
+
+void gfx_destroy_quad(GfxQuad *q)
+{
+    if (q->vao) glDeleteVertexArrays(1, &q->vao);
+    if (q->vbo) glDeleteBuffers(1, &q->vbo);
+    if (q->ebo) glDeleteBuffers(1, &q->ebo);
+    q->vao = q->vbo = q->ebo = 0;
+}
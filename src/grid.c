@@ -0,0 +1,161 @@
+// src/grid.c
+#include "grid.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int clampi(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+static int col_of(const Grid *gr, float x)
+{
+    return clampi((int)floorf((x - gr->min_x) / gr->cell), 0, gr->cols - 1);
+}
+
+static int row_of(const Grid *gr, float y)
+{
+    return clampi((int)floorf((y - gr->min_y) / gr->cell), 0, gr->rows - 1);
+}
+
+int grid_build(Grid *gr, float min_x, float min_y, float max_x, float max_y, float cell,
+               const GridItem *items, int count, int *order)
+{
+    memset(gr, 0, sizeof(*gr));
+    if (cell <= 0.0f || max_x < min_x || max_y < min_y || count < 0) return 0;
+    gr->min_x = min_x;
+    gr->min_y = min_y;
+    gr->cell = cell;
+    gr->cols = (int)ceilf((max_x - min_x) / cell);
+    gr->rows = (int)ceilf((max_y - min_y) / cell);
+    if (gr->cols < 1) gr->cols = 1;
+    if (gr->rows < 1) gr->rows = 1;
+
+    int cells = gr->cols * gr->rows;
+    gr->start = (int*)calloc((size_t)cells + 1, sizeof(int));
+    int *cell_of = (int*)malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (!gr->start || !cell_of) {
+        free(gr->start); free(cell_of);
+        gr->start = NULL;
+        return 0;
+    }
+
+    /* counting sort by cell */
+    for (int i = 0; i < count; ++i) {
+        int c = row_of(gr, items[i].y) * gr->cols + col_of(gr, items[i].x);
+        cell_of[i] = c;
+        gr->start[c + 1]++;
+        if (items[i].hx > gr->max_hx) gr->max_hx = items[i].hx;
+        if (items[i].hy > gr->max_hy) gr->max_hy = items[i].hy;
+    }
+    for (int c = 0; c < cells; ++c) gr->start[c + 1] += gr->start[c];
+
+    /* start[c] doubles as the write cursor, then gets shifted back */
+    for (int i = 0; i < count; ++i) order[gr->start[cell_of[i]]++] = i;
+    for (int c = cells; c > 0; --c) gr->start[c] = gr->start[c - 1];
+    gr->start[0] = 0;
+
+    free(cell_of);
+    return 1;
+}
+
+void grid_free(Grid *gr)
+{
+    free(gr->start);
+    memset(gr, 0, sizeof(*gr));
+}
+
+int grid_cell_of(const Grid *gr, float x, float y)
+{
+    return row_of(gr, y) * gr->cols + col_of(gr, x);
+}
+
+int grid_query(const Grid *gr, float x0, float y0, float x1, float y1,
+               int *cx0, int *cy0, int *cx1, int *cy1)
+{
+    if (!gr->start || x1 < x0 || y1 < y0) return 0;
+    /* items outside the grid bounds sit in the edge cells, so a box past the
+       edge still clamps onto them */
+    *cx0 = col_of(gr, x0 - gr->max_hx);
+    *cx1 = col_of(gr, x1 + gr->max_hx);
+    *cy0 = row_of(gr, y0 - gr->max_hy);
+    *cy1 = row_of(gr, y1 + gr->max_hy);
+    return 1;
+}
+
+/* boxes are binned this much larger than they are, so rounding in the callers'
+   own overlap tests can never find a hit in a cell the box was left out of */
+#define GRID_BINS_PAD 1e-4f
+
+static int bins_col(const GridBins *b, float x)
+{
+    return clampi((int)floorf((x - b->min_x) / b->cell), 0, b->cols - 1);
+}
+
+static int bins_row(const GridBins *b, float y)
+{
+    return clampi((int)floorf((y - b->min_y) / b->cell), 0, b->rows - 1);
+}
+
+int grid_bins_build(GridBins *b, float min_x, float min_y, float max_x, float max_y, float cell,
+                    const GridItem *items, int count)
+{
+    memset(b, 0, sizeof(*b));
+    if (cell <= 0.0f || max_x < min_x || max_y < min_y || count < 0) return 0;
+    b->min_x = min_x;
+    b->min_y = min_y;
+    b->cell = cell;
+    b->cols = (int)ceilf((max_x - min_x) / cell);
+    b->rows = (int)ceilf((max_y - min_y) / cell);
+    if (b->cols < 1) b->cols = 1;
+    if (b->rows < 1) b->rows = 1;
+
+    int cells = b->cols * b->rows;
+    b->start = (int*)calloc((size_t)cells + 1, sizeof(int));
+    if (!b->start) return 0;
+
+    /* count, prefix sum, fill: two passes over every item's cell range */
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < count; ++i) {
+            int cx0 = bins_col(b, items[i].x - items[i].hx - GRID_BINS_PAD);
+            int cx1 = bins_col(b, items[i].x + items[i].hx + GRID_BINS_PAD);
+            int cy0 = bins_row(b, items[i].y - items[i].hy - GRID_BINS_PAD);
+            int cy1 = bins_row(b, items[i].y + items[i].hy + GRID_BINS_PAD);
+            for (int y = cy0; y <= cy1; ++y) {
+                for (int x = cx0; x <= cx1; ++x) {
+                    int c = y * b->cols + x;
+                    if (pass == 0) b->start[c + 1]++;
+                    else b->items[b->start[c]++] = i;
+                }
+            }
+        }
+        if (pass == 0) {
+            for (int c = 0; c < cells; ++c) b->start[c + 1] += b->start[c];
+            b->items = (int*)malloc(sizeof(int) * (b->start[cells] > 0 ? b->start[cells] : 1));
+            if (!b->items) {
+                grid_bins_free(b);
+                return 0;
+            }
+        }
+    }
+    /* start[c] was the write cursor, shift it back as grid_build does */
+    for (int c = cells; c > 0; --c) b->start[c] = b->start[c - 1];
+    b->start[0] = 0;
+    return 1;
+}
+
+void grid_bins_free(GridBins *b)
+{
+    free(b->start);
+    free(b->items);
+    memset(b, 0, sizeof(*b));
+}
+
+int grid_bins_query(const GridBins *b, float x0, float y0, float x1, float y1,
+                    int *cx0, int *cy0, int *cx1, int *cy1)
+{
+    if (!b->start || x1 < x0 || y1 < y0) return 0;
+    *cx0 = bins_col(b, x0);
+    *cx1 = bins_col(b, x1);
+    *cy0 = bins_row(b, y0);
+    *cy1 = bins_row(b, y1);
+    return 1;
+}
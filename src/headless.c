@@ -0,0 +1,206 @@
+// src/headless.c
+#include "headless.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PMAN_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#ifdef PMAN_HAVE_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+#ifdef PMAN_HAVE_EGL
+static int init_egl(Headless *h)
+{
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+
+    /* the surfaceless platform needs neither X nor a DRM node */
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (get_platform_display)
+        dpy = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (dpy == EGL_NO_DISPLAY) dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (dpy == EGL_NO_DISPLAY) return 0;
+
+    EGLint major, minor;
+    if (!eglInitialize(dpy, &major, &minor)) return 0;
+    if (!eglBindAPI(EGL_OPENGL_API)) { eglTerminate(dpy); return 0; }
+
+    /* EGL_SURFACE_TYPE defaults to EGL_WINDOW_BIT, which surfaceless has none of */
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint count = 0;
+    if (!eglChooseConfig(dpy, config_attribs, &config, 1, &count) || count == 0) {
+        eglTerminate(dpy);
+        return 0;
+    }
+
+    const EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, context_attribs);
+    if (ctx == EGL_NO_CONTEXT) { eglTerminate(dpy); return 0; }
+
+    /* EGL_KHR_surfaceless_context: current without any surface */
+    if (!eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx) ||
+        !gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(dpy, ctx);
+        eglTerminate(dpy);
+        return 0;
+    }
+
+    h->egl_display = dpy;
+    h->egl_context = ctx;
+    h->backend = HEADLESS_EGL;
+    return 1;
+}
+
+static void shutdown_egl(Headless *h)
+{
+    EGLDisplay dpy = (EGLDisplay)h->egl_display;
+    eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(dpy, (EGLContext)h->egl_context);
+    eglTerminate(dpy);
+    h->egl_display = h->egl_context = NULL;
+}
+#endif
+
+#ifdef PMAN_HAVE_OSMESA
+static int init_osmesa(Headless *h)
+{
+    const int attribs[] = {
+        OSMESA_FORMAT, OSMESA_RGBA,
+        OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+        OSMESA_CONTEXT_MAJOR_VERSION, 3,
+        OSMESA_CONTEXT_MINOR_VERSION, 3,
+        0
+    };
+    OSMesaContext ctx = OSMesaCreateContextAttribs(attribs, NULL);
+    if (!ctx) return 0;
+
+    h->osmesa_buf = (unsigned char*)malloc((size_t)h->width * h->height * 4);
+    if (!h->osmesa_buf ||
+        !OSMesaMakeCurrent(ctx, h->osmesa_buf, GL_UNSIGNED_BYTE, h->width, h->height) ||
+        !gladLoadGLLoader((GLADloadproc)OSMesaGetProcAddress)) {
+        free(h->osmesa_buf);
+        h->osmesa_buf = NULL;
+        OSMesaDestroyContext(ctx);
+        return 0;
+    }
+
+    h->osmesa_context = ctx;
+    h->backend = HEADLESS_OSMESA;
+    return 1;
+}
+
+static void shutdown_osmesa(Headless *h)
+{
+    OSMesaDestroyContext((OSMesaContext)h->osmesa_context);
+    h->osmesa_context = NULL;
+    free(h->osmesa_buf);
+    h->osmesa_buf = NULL;
+}
+#endif
+
+static void shutdown_context(Headless *h)
+{
+#ifdef PMAN_HAVE_EGL
+    if (h->backend == HEADLESS_EGL) shutdown_egl(h);
+#endif
+#ifdef PMAN_HAVE_OSMESA
+    if (h->backend == HEADLESS_OSMESA) shutdown_osmesa(h);
+#endif
+    h->backend = HEADLESS_NONE;
+}
+
+int headless_init(Headless *h, int width, int height)
+{
+    if (!h || width <= 0 || height <= 0) return 0;
+    memset(h, 0, sizeof(*h));
+    h->width = width;
+    h->height = height;
+
+#ifdef PMAN_HAVE_EGL
+    if (!h->backend && !init_egl(h)) fprintf(stderr, "headless: EGL surfaceless context failed\n");
+#endif
+#ifdef PMAN_HAVE_OSMESA
+    if (!h->backend && !init_osmesa(h)) fprintf(stderr, "headless: OSMesa context failed\n");
+#endif
+    if (!h->backend) {
+        fprintf(stderr, "headless: no offscreen backend available (build with -DPMAN_HAVE_EGL or -DPMAN_HAVE_OSMESA)\n");
+        return 0;
+    }
+
+    glGenRenderbuffers(1, &h->color_rb);
+    glBindRenderbuffer(GL_RENDERBUFFER, h->color_rb);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenFramebuffers(1, &h->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, h->fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, h->color_rb);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "headless: framebuffer incomplete\n");
+        headless_shutdown(h);
+        return 0;
+    }
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    return 1;
+}
+
+void headless_shutdown(Headless *h)
+{
+    if (!h || !h->backend) return;
+    if (h->fbo) glDeleteFramebuffers(1, &h->fbo);
+    if (h->color_rb) glDeleteRenderbuffers(1, &h->color_rb);
+    h->fbo = h->color_rb = 0;
+    shutdown_context(h);
+}
+
+const char *headless_backend_name(const Headless *h)
+{
+    switch (h->backend) {
+    case HEADLESS_EGL:    return "egl-surfaceless";
+    case HEADLESS_OSMESA: return "osmesa";
+    default:              return "none";
+    }
+}
+
+void headless_begin_frame(Headless *h)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, h->fbo);
+    glViewport(0, 0, h->width, h->height);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+int headless_read_rgba(Headless *h, unsigned char *out)
+{
+    size_t row = (size_t)h->width * 4;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, h->fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, h->width, h->height, GL_RGBA, GL_UNSIGNED_BYTE, out);
+    if (glGetError() != GL_NO_ERROR) return 0;
+
+    /* GL rows start at the bottom; flip in place */
+    unsigned char *tmp = (unsigned char*)malloc(row);
+    if (!tmp) return 0;
+    for (int y = 0; y < h->height / 2; ++y) {
+        unsigned char *a = out + (size_t)y * row;
+        unsigned char *b = out + (size_t)(h->height - 1 - y) * row;
+        memcpy(tmp, a, row);
+        memcpy(a, b, row);
+        memcpy(b, tmp, row);
+    }
+    free(tmp);
+    return 1;
+}
@@ -0,0 +1,231 @@
+// src/headless_main.c
+// Offscreen driver: runs the game with scripted input at 60 fps (two SIM_DT ticks a frame),
+// renders every frame through the headless backend (or, with --software, the
+// CPU rasterizer and no GL at all) and optionally writes PPMs.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "game.h"
+#include "gfx.h"
+#include "headless.h"
+#include "level.h"
+
+#define HEADLESS_FPS 60
+#define MAX_SCRIPT_KEYS 64
+
+/* "R:0-30,D:30-100": hold Right for frames [0,30), Down for [30,100).
+   Keys are U, D, L, R. */
+typedef struct { char key; int from, to; } ScriptKey;
+
+static int parse_script(const char *s, ScriptKey *keys, int max)
+{
+    int n = 0;
+    while (s && *s) {
+        ScriptKey k;
+        int used = 0;
+        if (n >= max || sscanf(s, "%c:%d-%d%n", &k.key, &k.from, &k.to, &used) != 3) return -1;
+        if (!strchr("UDLR", k.key)) return -1;
+        keys[n++] = k;
+        s += used;
+        if (*s == ',') s++;
+    }
+    return n;
+}
+
+static int script_held(const ScriptKey *keys, int n, char key, int frame)
+{
+    for (int i = 0; i < n; ++i)
+        if (keys[i].key == key && frame >= keys[i].from && frame < keys[i].to) return 1;
+    return 0;
+}
+
+static int write_ppm(const char *path, const unsigned char *rgba, int w, int h)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return 0;
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for (int i = 0; i < w * h; ++i) fwrite(rgba + (size_t)i * 4, 1, 3, f);
+    return fclose(f) == 0;
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--frames N] [--size WxH] [--keys SCRIPT] [--dump FRAME|all] [--out PREFIX] [--pellet-bitmask]\n"
+            "          [--shaders DIR] [--shader-cache DIR|none] [--maze WxH[,seed]] [--tiles]\n"
+            "          [--sprites] [--ghosts] [--software] [--threads N]\n"
+            "  SCRIPT is e.g. R:0-30,D:30-100 (key:first-last frame, keys U D L R)\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    int frames = 120, width = 1280, height = 720;
+    int dump_frame = -1, dump_all = 0;
+    const char *out_prefix = "frame";
+    const char *script = NULL;
+    const char *shader_dir = "shaders";
+    const char *shader_cache = NULL;
+    const char *maze = NULL;
+    int tiles = 0;
+    int sprites = 0;
+    int ghosts = 0;
+    int software = 0, threads = 0;
+    PelletStorage pellet_storage = PELLETS_COMPACT;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--pellet-bitmask") == 0) { pellet_storage = PELLETS_BITMASK; continue; }
+        if (strcmp(a, "--tiles") == 0) { tiles = 1; continue; }
+        if (strcmp(a, "--sprites") == 0) { sprites = 1; continue; }
+        if (strcmp(a, "--ghosts") == 0) { ghosts = 1; continue; }
+        if (strcmp(a, "--software") == 0) { software = 1; continue; }
+        if (!v) { usage(argv[0]); return EXIT_FAILURE; }
+        if (strcmp(a, "--frames") == 0) frames = atoi(v);
+        else if (strcmp(a, "--size") == 0) {
+            if (sscanf(v, "%dx%d", &width, &height) != 2) { usage(argv[0]); return EXIT_FAILURE; }
+        }
+        else if (strcmp(a, "--keys") == 0) script = v;
+        else if (strcmp(a, "--dump") == 0) {
+            if (strcmp(v, "all") == 0) dump_all = 1;
+            else dump_frame = atoi(v);
+        }
+        else if (strcmp(a, "--out") == 0) out_prefix = v;
+        else if (strcmp(a, "--shaders") == 0) shader_dir = v;
+        else if (strcmp(a, "--shader-cache") == 0) shader_cache = v;
+        else if (strcmp(a, "--maze") == 0) maze = v;
+        else if (strcmp(a, "--threads") == 0) threads = atoi(v);
+        else { usage(argv[0]); return EXIT_FAILURE; }
+        i++;
+    }
+    if (frames <= 0 || width <= 0 || height <= 0) { usage(argv[0]); return EXIT_FAILURE; }
+
+    ScriptKey keys[MAX_SCRIPT_KEYS];
+    int key_count = parse_script(script, keys, MAX_SCRIPT_KEYS);
+    if (key_count < 0) {
+        fprintf(stderr, "bad --keys script: %s\n", script);
+        return EXIT_FAILURE;
+    }
+
+    if (software && (tiles || sprites)) {
+        fprintf(stderr, "--tiles and --sprites need GL, ignored with --software\n");
+        tiles = sprites = 0;
+    }
+
+    Headless hl;
+    memset(&hl, 0, sizeof(hl));
+    GLuint program = 0, board_program = 0, sprite_program = 0;
+    GfxQuad quad;
+    memset(&quad, 0, sizeof(quad));
+    Game game;
+    FrameSnapshot snap = {0};
+    unsigned char *pixels = (unsigned char*)malloc((size_t)width * height * 4);
+    int ok;
+
+    if (software) {
+        ok = pixels && game_init_software(&game, threads);
+        if (ok) printf("software: %d threads, %d-pixel tiles, %d-wide span fills\n",
+                       game.soft.threads, SOFT_TILE, softrast_lanes(&game.soft));
+    } else {
+        if (!headless_init(&hl, width, height)) { free(pixels); return EXIT_FAILURE; }
+        printf("headless: %s, %s\n", headless_backend_name(&hl), (const char*)glGetString(GL_RENDERER));
+
+        int cached = 0;
+        double t_shaders = seconds();
+        shader_cache = gfx_cache_dir(shader_cache);
+        program = gfx_create_program(shader_dir, "basic", shader_cache, &cached);
+        if (tiles) {
+            int board_cached = 0;
+            board_program = gfx_create_program(shader_dir, "board", shader_cache, &board_cached);
+            cached = cached && board_cached;
+        }
+        if (sprites) {
+            int sprite_cached = 0;
+            sprite_program = gfx_create_program(shader_dir, "sprite", shader_cache, &sprite_cached);
+            cached = cached && sprite_cached;
+        }
+        double shader_ms = (seconds() - t_shaders) * 1000.0;
+
+        ok = program && pixels && gfx_create_quad(&quad) &&
+             game_init(&game, program, quad.vao, quad.vbo, quad.ebo);
+        if (ok) printf("shaders: %s in %.1f ms\n", cached ? "program binary from cache" : "compiled and linked", shader_ms);
+    }
+    if (!ok) {
+        fprintf(stderr, "headless setup failed\n");
+        free(pixels);
+        if (!software) headless_shutdown(&hl);
+        return EXIT_FAILURE;
+    }
+    if (maze) {
+        Level lv;
+        int loaded = level_maze_from_spec(&lv, maze) && game_load_level(&game, &lv);
+        level_free(&lv);
+        if (!loaded) fprintf(stderr, "maze not loaded, playing the classic level\n");
+    }
+    if (!game_set_pellet_storage(&game, pellet_storage)) {
+        fprintf(stderr, "pellet storage switch failed\n");
+    }
+    if (ghosts) sim_set_ghost_count(&game.sim, GAME_GHOSTS);
+    if (tiles && !game_set_renderer(&game, RENDER_TILES, board_program)) {
+        fprintf(stderr, "tile renderer unavailable, drawing instances\n");
+    }
+    if (sprites && !game_set_sprites(&game, sprite_program)) {
+        fprintf(stderr, "sprites unavailable, drawing actor shapes\n");
+    }
+    if (!game_snapshot_alloc(&snap, &game.sim)) {
+        fprintf(stderr, "snapshot allocation failed\n");
+        ok = 0;
+    }
+
+    double start = seconds();
+    for (int f = 0; ok && f < frames; ++f) {
+        for (int t = 0; t < SIM_HZ / HEADLESS_FPS; ++t)
+            sim_update(&game.sim, SIM_DT,
+                       script_held(keys, key_count, 'U', f), script_held(keys, key_count, 'D', f),
+                       script_held(keys, key_count, 'L', f), script_held(keys, key_count, 'R', f));
+        game_snapshot(&game.sim, 1.0f, &snap);
+
+        if (!software) headless_begin_frame(&hl);
+        game_render(&game, &snap, width, height);
+
+        if (dump_all || f == dump_frame) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s_%05d.ppm", out_prefix, f);
+            if (software) softrast_read_rgba(&game.soft, pixels);
+            else if (!headless_read_rgba(&hl, pixels)) ok = 0;
+            if (!ok || !write_ppm(path, pixels, width, height)) {
+                fprintf(stderr, "failed to write %s\n", path);
+                ok = 0;
+            }
+        }
+    }
+    if (!software) glFinish();
+    double elapsed = seconds() - start;
+
+    if (ok) {
+        printf("%d frames at %dx%d in %.3f s (%.1f fps), %d pellets left, %d draw calls and %d of %d instances in the last frame\n",
+               frames, width, height, elapsed, frames / elapsed, game.sim.pellets_left,
+               game.draw_calls, game.visible_instances, WORLD_DYNAMIC_SLOTS + game.sim.wall_count + game.sim.pellet_count);
+    }
+
+    game_snapshot_free(&snap);
+    game_shutdown(&game);
+    if (!software) {
+        glDeleteProgram(program);
+        if (board_program) glDeleteProgram(board_program);
+        if (sprite_program) glDeleteProgram(sprite_program);
+        gfx_destroy_quad(&quad);
+        headless_shutdown(&hl);
+    }
+    free(pixels);
+    return ok ? 0 : EXIT_FAILURE;
+}
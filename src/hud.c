@@ -0,0 +1,209 @@
+// src/hud.c
+#include "hud.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/* one character on screen; attr 1 and 2 of hud.vs */
+typedef struct {
+    float x, y, w, h;
+    float r, g, b, glyph;
+} HudGlyph;
+
+#define HUD_FIRST_CHAR ' '
+#define HUD_LAST_CHAR 'Z'
+#define HUD_GLYPHS (HUD_LAST_CHAR - HUD_FIRST_CHAR + 1)
+#define HUD_ATLAS_COLS 16        // must match hud.vs
+#define HUD_ATLAS_ROWS ((HUD_GLYPHS + HUD_ATLAS_COLS - 1) / HUD_ATLAS_COLS)
+
+/* 5x7 font, ' ' to 'Z': five columns per glyph, bit 0 the top row */
+static const unsigned char font5x7[HUD_GLYPHS][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, // sp ! "
+    {0x14,0x7F,0x14,0x7F,0x14}, {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, // # $ %
+    {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00}, {0x00,0x1C,0x22,0x41,0x00}, // & ' (
+    {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08}, // ) * +
+    {0x00,0x40,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00}, // , - .
+    {0x20,0x10,0x08,0x04,0x02}, {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, // / 0 1
+    {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33}, {0x18,0x14,0x12,0x7F,0x10}, // 2 3 4
+    {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07}, // 5 6 7
+    {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00}, // 8 9 :
+    {0x00,0x40,0x34,0x00,0x00}, {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, // ; < =
+    {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06}, {0x3E,0x41,0x5D,0x59,0x4E}, // > ? @
+    {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22}, // A B C
+    {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, // D E F
+    {0x3E,0x41,0x41,0x51,0x73}, {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, // G H I
+    {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41}, {0x7F,0x40,0x40,0x40,0x40}, // J K L
+    {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E}, // M N O
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, // P Q R
+    {0x26,0x49,0x49,0x49,0x32}, {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F}, // S T U
+    {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F}, {0x63,0x14,0x08,0x14,0x63}, // V W X
+    {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43},                             // Y Z
+};
+
+static int glyph_index(char c)
+{
+    if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+    if (c < HUD_FIRST_CHAR || c > HUD_LAST_CHAR) c = '?';
+    return c - HUD_FIRST_CHAR;
+}
+
+/* R8 atlas, HUD_ATLAS_COLS glyph cells per row, texel row 0 = top of the
+   first cell row (hud.vs indexes it that way) */
+static GLuint build_atlas(void)
+{
+    enum { W = HUD_ATLAS_COLS * HUD_GLYPH_W, H = HUD_ATLAS_ROWS * HUD_GLYPH_H };
+    static unsigned char texels[W * H];
+    memset(texels, 0, sizeof(texels));
+    for (int g = 0; g < HUD_GLYPHS; ++g) {
+        int ox = (g % HUD_ATLAS_COLS) * HUD_GLYPH_W;
+        int oy = (g / HUD_ATLAS_COLS) * HUD_GLYPH_H;
+        for (int col = 0; col < 5; ++col)
+            for (int row = 0; row < 7; ++row)
+                if (font5x7[g][col] >> row & 1) texels[(oy + row) * W + ox + col] = 255;
+    }
+
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, W, H, 0, GL_RED, GL_UNSIGNED_BYTE, texels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return tex;
+}
+
+int hud_init(Hud *h, GLuint program, GLuint quad_vbo, GLuint quad_ebo, int scale)
+{
+    memset(h, 0, sizeof(*h));
+    h->program = program;
+    h->loc_uViewport = glGetUniformLocation(program, "uViewport");
+    h->loc_uFont = glGetUniformLocation(program, "uFont");
+    h->scale = scale > 0 ? scale : 1;
+
+    h->font_tex = build_atlas();
+    if (!h->font_tex) return 0;
+
+    glGenVertexArrays(1, &h->vao);
+    glGenBuffers(1, &h->vbo);
+    if (!h->vao || !h->vbo) return 0;
+    glBindVertexArray(h->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, h->vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(HudGlyph) * HUD_MAX_GLYPHS, NULL, GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(HudGlyph), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(HudGlyph), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ebo);
+    glBindVertexArray(0);
+    return 1;
+}
+
+void hud_shutdown(Hud *h)
+{
+    if (h->vao) glDeleteVertexArrays(1, &h->vao);
+    if (h->vbo) glDeleteBuffers(1, &h->vbo);
+    if (h->font_tex) glDeleteTextures(1, &h->font_tex);
+    memset(h, 0, sizeof(*h));
+}
+
+/* writes n characters as consecutive glyph slots from first, staged
+   HUD_FIELD_MAX at a time */
+static void upload_glyphs(Hud *h, int first, int x, int y, float r, float g, float b, const char *s, int n)
+{
+    HudGlyph staged[HUD_FIELD_MAX];
+    float cw = (float)(HUD_GLYPH_W * h->scale), ch = (float)(HUD_GLYPH_H * h->scale);
+    int done = 0;
+    while (done < n) {
+        int chunk = n - done < HUD_FIELD_MAX ? n - done : HUD_FIELD_MAX;
+        for (int i = 0; i < chunk; ++i) {
+            HudGlyph *q = &staged[i];
+            q->x = (float)x + cw * (float)(done + i);
+            q->y = (float)y;
+            q->w = cw;
+            q->h = ch;
+            q->r = r; q->g = g; q->b = b;
+            q->glyph = (float)glyph_index(s[done + i]);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(HudGlyph) * (first + done), sizeof(HudGlyph) * chunk, staged);
+        done += chunk;
+    }
+    h->glyph_uploads += (unsigned long long)n;
+}
+
+int hud_text(Hud *h, int x, int y, float r, float g, float b, const char *s)
+{
+    int n = (int)strlen(s);
+    if (h->count + n > HUD_MAX_GLYPHS) {
+        fprintf(stderr, "hud: no room for \"%s\"\n", s);
+        return 0;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, h->vbo);
+    upload_glyphs(h, h->count, x, y, r, g, b, s, n);
+    h->count += n;
+    return 1;
+}
+
+int hud_field(Hud *h, int x, int y, int width, float r, float g, float b)
+{
+    if (width <= 0 || width > HUD_FIELD_MAX || h->field_count == HUD_MAX_FIELDS ||
+        h->count + width > HUD_MAX_GLYPHS) {
+        fprintf(stderr, "hud: no room for a %d character field\n", width);
+        return -1;
+    }
+    /* the position and colour are written once; hud_set only rewrites the
+       slots whose character changed */
+    HudField *f = &h->fields[h->field_count];
+    f->first = h->count;
+    f->width = width;
+    memset(f->text, ' ', sizeof(f->text));
+    glBindBuffer(GL_ARRAY_BUFFER, h->vbo);
+    upload_glyphs(h, f->first, x, y, r, g, b, f->text, width);
+    h->count += width;
+    return h->field_count++;
+}
+
+int hud_set(Hud *h, int field, const char *s)
+{
+    if (field < 0 || field >= h->field_count) return 0;
+    HudField *f = &h->fields[field];
+    char next[HUD_FIELD_MAX];
+    int len = (int)strlen(s);
+    for (int i = 0; i < f->width; ++i) next[i] = i < len ? s[i] : ' ';
+
+    /* only the glyph index of a changed character is rewritten: position
+       and colour of the slot stay as hud_field left them */
+    int changed = 0;
+    for (int i = 0; i < f->width; ++i) {
+        if (next[i] == f->text[i]) continue;
+        if (!changed) glBindBuffer(GL_ARRAY_BUFFER, h->vbo);
+        float glyph = (float)glyph_index(next[i]);
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(HudGlyph) * (f->first + i) + offsetof(HudGlyph, glyph),
+                        sizeof(float), &glyph);
+        f->text[i] = next[i];
+        h->glyph_uploads++;
+        changed = 1;
+    }
+    return changed;
+}
+
+void hud_draw(const Hud *h, int fb_width, int fb_height)
+{
+    if (h->count == 0 || fb_width <= 0 || fb_height <= 0) return;
+    glViewport(0, 0, fb_width, fb_height);
+    glUseProgram(h->program);
+    glUniform2f(h->loc_uViewport, (float)fb_width, (float)fb_height);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, h->font_tex);
+    glUniform1i(h->loc_uFont, 0);
+    glBindVertexArray(h->vao);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, h->count);
+    glBindVertexArray(0);
+}
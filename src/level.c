@@ -0,0 +1,187 @@
+// src/level.c
+#include "level.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* maze geometry, world units */
+#define MAZE_PITCH 0.25f           /* corridor cell size, wall centre to wall centre */
+#define MAZE_WALL_HALF 0.015f      /* half thickness of the visible wall */
+
+int level_classic(Level *lv)
+{
+    static const Rect walls[] = {
+        { -0.95f,  0.0f, 0.05f, 0.95f },  // left outer
+        {  0.95f,  0.0f, 0.05f, 0.95f },  // right outer
+        {  0.00f,  0.95f, 0.90f, 0.05f },  // top outer
+        {  0.00f, -0.95f, 0.90f, 0.05f },  // bottom outer
+
+        { -0.50f,  0.72f, 0.30f, 0.04f },
+        {  0.50f,  0.72f, 0.30f, 0.04f },
+        { -0.50f, -0.72f, 0.30f, 0.04f },
+        {  0.50f, -0.72f, 0.30f, 0.04f },
+
+        { -0.65f,  0.20f, 0.04f, 0.40f },
+        { -0.65f, -0.20f, 0.04f, 0.40f },
+        {  0.65f,  0.20f, 0.04f, 0.40f },
+        {  0.65f, -0.20f, 0.04f, 0.40f },
+
+        {  0.00f,  0.00f, 0.16f, 0.12f },
+
+        { -0.28f,  0.12f, 0.10f, 0.03f },
+        { -0.28f, -0.12f, 0.10f, 0.03f },
+        {  0.28f,  0.12f, 0.10f, 0.03f },
+        {  0.28f, -0.12f, 0.10f, 0.03f },
+
+        { -0.80f,  0.80f, 0.12f, 0.12f },
+        {  0.80f,  0.80f, 0.12f, 0.12f },
+        { -0.80f, -0.80f, 0.12f, 0.12f },
+        {  0.80f, -0.80f, 0.12f, 0.12f }
+    };
+    int n = (int)(sizeof(walls) / sizeof(walls[0]));
+
+    memset(lv, 0, sizeof(*lv));
+    lv->walls = (Rect*)malloc(sizeof(walls));
+    if (!lv->walls) return 0;
+    memcpy(lv->walls, walls, sizeof(walls));
+    lv->wall_count = n;
+    lv->min_x = -1.0f; lv->max_x = 1.0f;
+    lv->min_y = -1.0f; lv->max_y = 1.0f;
+    lv->start_x = 0.3f; lv->start_y = 0.3f;
+    return 1;
+}
+
+static unsigned next_rand(unsigned *s)
+{
+    /* xorshift32 */
+    unsigned x = *s;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *s = x;
+}
+
+static int push_wall(Level *lv, int *cap, float x0, float y0, float x1, float y1)
+{
+    if (lv->wall_count == *cap) {
+        int ncap = *cap ? *cap * 2 : 256;
+        Rect *tmp = (Rect*)realloc(lv->walls, sizeof(Rect) * ncap);
+        if (!tmp) return 0;
+        lv->walls = tmp;
+        *cap = ncap;
+    }
+    lv->walls[lv->wall_count++] = sim_wall_from_box(0.5f * (x0 + x1), 0.5f * (y0 + y1),
+                                                     0.5f * (x1 - x0), 0.5f * (y1 - y0));
+    return 1;
+}
+
+/* Cell (x, y) keeps its east and north wall bits; the west and south edges of
+   the maze are the east/north walls of a virtual outer ring, always closed. */
+#define WALL_E 1
+#define WALL_N 2
+
+int level_maze(Level *lv, int cols, int rows, unsigned seed)
+{
+    memset(lv, 0, sizeof(*lv));
+    if (cols < 1 || rows < 1) return 0;
+
+    int cells = cols * rows;
+    unsigned char *wall = (unsigned char*)malloc((size_t)cells);
+    unsigned char *seen = (unsigned char*)calloc((size_t)cells, 1);
+    int *stack = (int*)malloc(sizeof(int) * cells);
+    if (!wall || !seen || !stack) {
+        free(wall); free(seen); free(stack);
+        return 0;
+    }
+    memset(wall, WALL_E | WALL_N, (size_t)cells);
+
+    /* carve: depth-first walk that knocks down the wall to a random unseen neighbour */
+    unsigned rng = seed ? seed : 0x9E3779B9u;
+    int top = 0;
+    stack[top++] = 0;
+    seen[0] = 1;
+    while (top > 0) {
+        int c = stack[top - 1];
+        int x = c % cols, y = c / cols;
+        int next[4], dir[4], n = 0;
+        if (x + 1 < cols && !seen[c + 1])    { next[n] = c + 1;    dir[n++] = 0; }
+        if (x > 0 && !seen[c - 1])           { next[n] = c - 1;    dir[n++] = 1; }
+        if (y + 1 < rows && !seen[c + cols]) { next[n] = c + cols; dir[n++] = 2; }
+        if (y > 0 && !seen[c - cols])        { next[n] = c - cols; dir[n++] = 3; }
+        if (n == 0) { top--; continue; }
+
+        int k = (int)(next_rand(&rng) % (unsigned)n);
+        switch (dir[k]) {
+        case 0: wall[c] &= ~WALL_E; break;
+        case 1: wall[c - 1] &= ~WALL_E; break;
+        case 2: wall[c] &= ~WALL_N; break;
+        case 3: wall[c - cols] &= ~WALL_N; break;
+        }
+        seen[next[k]] = 1;
+        stack[top++] = next[k];
+    }
+
+    float ox = -0.5f * cols * MAZE_PITCH;
+    float oy = -0.5f * rows * MAZE_PITCH;
+    float t = MAZE_WALL_HALF;
+    int cap = 0, ok = 1;
+
+    /* outer frame */
+    float x1 = ox + cols * MAZE_PITCH, y1 = oy + rows * MAZE_PITCH;
+    ok = ok && push_wall(lv, &cap, ox - t, oy - t, x1 + t, oy + t);
+    ok = ok && push_wall(lv, &cap, ox - t, y1 - t, x1 + t, y1 + t);
+    ok = ok && push_wall(lv, &cap, ox - t, oy + t, ox + t, y1 - t);
+    ok = ok && push_wall(lv, &cap, x1 - t, oy + t, x1 + t, y1 - t);
+
+    /* interior north walls, merged into horizontal runs */
+    for (int y = 0; y + 1 < rows && ok; ++y) {
+        float wy = oy + (y + 1) * MAZE_PITCH;
+        for (int x = 0; x < cols && ok; ) {
+            if (!(wall[y * cols + x] & WALL_N)) { x++; continue; }
+            int run = x;
+            while (run < cols && (wall[y * cols + run] & WALL_N)) run++;
+            ok = push_wall(lv, &cap, ox + x * MAZE_PITCH - t, wy - t, ox + run * MAZE_PITCH + t, wy + t);
+            x = run;
+        }
+    }
+    /* interior east walls, merged into vertical runs */
+    for (int x = 0; x + 1 < cols && ok; ++x) {
+        float wx = ox + (x + 1) * MAZE_PITCH;
+        for (int y = 0; y < rows && ok; ) {
+            if (!(wall[y * cols + x] & WALL_E)) { y++; continue; }
+            int run = y;
+            while (run < rows && (wall[run * cols + x] & WALL_E)) run++;
+            ok = push_wall(lv, &cap, wx - t, oy + y * MAZE_PITCH - t, wx + t, oy + run * MAZE_PITCH + t);
+            y = run;
+        }
+    }
+
+    free(wall); free(seen); free(stack);
+    if (!ok) {
+        fprintf(stderr, "level_maze: out of memory\n");
+        level_free(lv);
+        return 0;
+    }
+
+    lv->min_x = ox; lv->max_x = x1;
+    lv->min_y = oy; lv->max_y = y1;
+    lv->start_x = ox + 0.5f * MAZE_PITCH;
+    lv->start_y = oy + 0.5f * MAZE_PITCH;
+    return 1;
+}
+
+int level_maze_from_spec(Level *lv, const char *spec)
+{
+    int cols, rows;
+    unsigned seed = 1;
+    if (!spec || sscanf(spec, "%dx%d,%u", &cols, &rows, &seed) < 2 || cols < 1 || rows < 1) {
+        fprintf(stderr, "bad maze size '%s', expected WxH[,seed]\n", spec ? spec : "");
+        memset(lv, 0, sizeof(*lv));
+        return 0;
+    }
+    return level_maze(lv, cols, rows, seed);
+}
+
+void level_free(Level *lv)
+{
+    free(lv->walls);
+    memset(lv, 0, sizeof(*lv));
+}
@@ -1,70 +1,105 @@
 // src/main.c
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #define GLFW_INCLUDE_NONE
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "capture.h"
+#include "damage.h"
+#include "dynres.h"
 #include "game.h"
+#include "gfx.h"
+#include "hud.h"
 #include "input.h"
+#include "level.h"
+#include "pacing.h"
+#include "render_thread.h"
 
-/* Vertex & Fragment Shaders  */
-static const char *vertex_src =
-"#version 330 core\n"
-"layout(location = 0) in vec2 aPos;\n"
-"uniform vec2 uOffset;\n"
-"uniform vec2 uScale;\n"
-"void main() {\n"
-"    vec2 p = aPos * uScale + uOffset;\n"
-"    gl_Position = vec4(p, 0.0, 1.0);\n"
-"}\n";
-
-static const char *fragment_src =
-"#version 330 core\n"
-"uniform vec3 uColor;\n"
-"out vec4 FragColor;\n"
-"void main() {\n"
-"    FragColor = vec4(uColor, 1.0);\n"
-"}\n";
-
-/* Shader helpers */
-static GLuint compile_shader(GLenum type, const char *src) {
-    GLuint s = glCreateShader(type);
-    glShaderSource(s, 1, &src, NULL);
-    glCompileShader(s);
-    GLint ok = 0;
-    glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
-    if (!ok) {
-        char log[512];
-        glGetShaderInfoLog(s, sizeof(log), NULL, log);
-        fprintf(stderr, "Shader compile error: %s\n", log);
-        glDeleteShader(s);
-        return 0;
-    }
-    return s;
+/* nominal rate written into captures; frames are whatever the swap interval delivers */
+#define CAPTURE_FPS 60
+/* longest sleep on a frame with nothing to redraw; input wakes it early */
+#define IDLE_WAIT (1.0 / 60.0)
+/* --pace: slack between the expected end of a frame's work and the vblank */
+#define PACE_MARGIN_MS 1.0
+/* HUD: screen pixels per font pixel, margin from the window corner */
+#define HUD_SCALE 2
+#define HUD_MARGIN 8
+/* dynamic resolution: frames averaged into each controller sample */
+#define DYNRES_FRAMES 8
+
+/* set when the window system lost our pixels (uncovered, restored) */
+static int window_exposed = 0;
+
+static void on_window_refresh(GLFWwindow *window)
+{
+    (void)window;
+    window_exposed = 1;
 }
 
-static GLuint link_program(GLuint v, GLuint f) {
-    GLuint p = glCreateProgram();
-    glAttachShader(p, v);
-    glAttachShader(p, f);
-    glLinkProgram(p);
-    GLint ok = 0;
-    glGetProgramiv(p, GL_LINK_STATUS, &ok);
-    if (!ok) {
-        char log[512];
-        glGetProgramInfoLog(p, sizeof(log), NULL, log);
-        fprintf(stderr, "Program link error: %s\n", log);
-        glDeleteProgram(p);
-        return 0;
-    }
-    return p;
+/* fields of the HUD: the labels are static text, only these change */
+enum { HUD_SCORE, HUD_FPS, HUD_UPDATE, HUD_RENDER, HUD_GPU, HUD_FIELDS };
+
+static int hud_layout(Hud *hud, int fields[HUD_FIELDS])
+{
+    static const char *labels[HUD_FIELDS] = { "SCORE", "FPS", "UPDATE", "RENDER", "GPU" };
+    static const char *units[HUD_FIELDS] = { "", "", "MS", "MS", "MS" };
+    int cw = HUD_GLYPH_W * HUD_SCALE, lh = (HUD_GLYPH_H + 2) * HUD_SCALE;
+    for (int i = 0; i < HUD_FIELDS; ++i) {
+        int y = HUD_MARGIN + i * lh;
+        if (!hud_text(hud, HUD_MARGIN, y, 0.6f, 0.6f, 0.8f, labels[i])) return 0;
+        fields[i] = hud_field(hud, HUD_MARGIN + 7 * cw, y, 6, 1.0f, 1.0f, 1.0f);
+        if (fields[i] < 0) return 0;
+        if (units[i][0] && !hud_text(hud, HUD_MARGIN + 14 * cw, y, 0.6f, 0.6f, 0.8f, units[i])) return 0;
+    }
+    return 1;
 }
 
-int main(void)
+int main(int argc, char **argv)
 {
+    PelletStorage pellet_storage = PELLETS_COMPACT;
+    int threaded = 0;
+    int use_damage = 1;
+    const char *capture_path = NULL;
+    const char *shader_dir = "shaders";
+    const char *shader_cache = NULL;
+    const char *maze = NULL;
+    int tiles = 0;
+    int pace = 0;
+    int use_hud = 1;
+    int sprites = 0;
+    int ghosts = 0;
+    float target_ms = 1000.0f / 60.0f;
+    float min_scale = 0.5f, max_scale = 1.0f;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--pellet-bitmask") == 0) pellet_storage = PELLETS_BITMASK;
+        else if (strcmp(argv[i], "--render-thread") == 0) threaded = 1;
+        else if (strcmp(argv[i], "--no-damage") == 0) use_damage = 0;
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) capture_path = argv[++i];
+        else if (strcmp(argv[i], "--shaders") == 0 && i + 1 < argc) shader_dir = argv[++i];
+        else if (strcmp(argv[i], "--shader-cache") == 0 && i + 1 < argc) shader_cache = argv[++i];
+        else if (strcmp(argv[i], "--maze") == 0 && i + 1 < argc) maze = argv[++i];
+        else if (strcmp(argv[i], "--tiles") == 0) tiles = 1;
+        else if (strcmp(argv[i], "--pace") == 0) pace = 1;
+        else if (strcmp(argv[i], "--no-hud") == 0) use_hud = 0;
+        else if (strcmp(argv[i], "--sprites") == 0) sprites = 1;
+        else if (strcmp(argv[i], "--ghosts") == 0) ghosts = 1;
+        else if (strcmp(argv[i], "--target-ms") == 0 && i + 1 < argc) target_ms = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--res-scale") == 0 && i + 1 < argc &&
+                 sscanf(argv[i + 1], "%f,%f", &min_scale, &max_scale) == 2) ++i;
+        else {
+            fprintf(stderr, "usage: %s [--pellet-bitmask] [--render-thread] [--no-damage] [--capture out.y4m]"
+                            " [--shaders DIR] [--shader-cache DIR|none] [--maze WxH[,seed]] [--tiles] [--pace]"
+                            " [--no-hud] [--sprites] [--ghosts] [--target-ms MS] [--res-scale MIN,MAX]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    /* snapshots carry pellet state as alive bits, which needs stable indices */
+    if (threaded) pellet_storage = PELLETS_BITMASK;
+
     if (!glfwInit()) {
         fprintf(stderr, "GLFW init failed\n");
         return EXIT_FAILURE;
@@ -91,96 +126,355 @@ int main(void)
         return EXIT_FAILURE;
     }
 
-    /* Unit quad geometry (centered at origin, coordinates in [-0.5, +0.5]) */
-    float vertices[] = {
-        -0.5f, -0.5f,
-         0.5f, -0.5f,
-         0.5f,  0.5f,
-        -0.5f,  0.5f
-    };
-    unsigned int indices[] = {0,1,2, 2,3,0};
-
-    GLuint VAO = 0, VBO = 0, EBO = 0;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    /* Compile & link shaders */
-    GLuint vsh = compile_shader(GL_VERTEX_SHADER, vertex_src);
-    GLuint fsh = compile_shader(GL_FRAGMENT_SHADER, fragment_src);
-    if (!vsh || !fsh) {
-        fprintf(stderr, "shader compile failed\n");
+    /* shared unit quad + the world program */
+    GfxQuad quad;
+    if (!gfx_create_quad(&quad)) {
+        fprintf(stderr, "quad setup failed\n");
         return EXIT_FAILURE;
     }
-    GLuint program = link_program(vsh, fsh);
-    glDeleteShader(vsh);
-    glDeleteShader(fsh);
-    if (!program) {
-        fprintf(stderr, "program link failed\n");
-        return EXIT_FAILURE;
+    shader_cache = gfx_cache_dir(shader_cache);
+    double t_shaders = glfwGetTime();
+    int cached = 0;
+    GLuint program = gfx_create_program(shader_dir, "basic", shader_cache, &cached);
+    if (!program) return EXIT_FAILURE;
+    GLuint board_program = 0;
+    if (tiles) {
+        int board_cached = 0;
+        board_program = gfx_create_program(shader_dir, "board", shader_cache, &board_cached);
+        cached = cached && board_cached;
     }
-
-    /* Get uniform locations */
-    GLint loc_uOffset = glGetUniformLocation(program, "uOffset");
-    GLint loc_uScale  = glGetUniformLocation(program, "uScale");
-    GLint loc_uColor  = glGetUniformLocation(program, "uColor");
+    GLuint sprite_program = 0;
+    if (sprites) {
+        int sprite_cached = 0;
+        sprite_program = gfx_create_program(shader_dir, "sprite", shader_cache, &sprite_cached);
+        cached = cached && sprite_cached;
+    }
+    GLuint hud_program = 0;
+    if (use_hud) {
+        int hud_cached = 0;
+        hud_program = gfx_create_program(shader_dir, "hud", shader_cache, &hud_cached);
+        cached = cached && hud_cached;
+    }
+    printf("shaders: %s in %.1f ms\n", cached ? "program binary from cache" : "compiled and linked",
+           (glfwGetTime() - t_shaders) * 1000.0);
 
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
     /* Initialize game (passes program & VAO so game_render can use them) */
     Game game;
-    if (!game_init(&game, program, VAO)) {
+    if (!game_init(&game, program, quad.vao, quad.vbo, quad.ebo)) {
         fprintf(stderr, "game init failed\n");
         // cleanup
         glDeleteProgram(program);
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
-        glDeleteBuffers(1, &EBO);
+        gfx_destroy_quad(&quad);
         glfwDestroyWindow(window);
         glfwTerminate();
         return EXIT_FAILURE;
     }
+    if (maze) {
+        Level lv;
+        int loaded = level_maze_from_spec(&lv, maze) && game_load_level(&game, &lv);
+        level_free(&lv);
+        if (!loaded) fprintf(stderr, "maze not loaded, playing the classic level\n");
+    }
+    if (!game_set_pellet_storage(&game, pellet_storage)) {
+        fprintf(stderr, "pellet storage switch failed\n");
+    }
+    if (ghosts) sim_set_ghost_count(&game.sim, GAME_GHOSTS);
+    if (tiles && !game_set_renderer(&game, RENDER_TILES, board_program)) {
+        fprintf(stderr, "tile renderer unavailable, drawing instances\n");
+    }
+    if (sprites && !game_set_sprites(&game, sprite_program)) {
+        fprintf(stderr, "sprites unavailable, drawing actor shapes\n");
+    }
+
+    Capture capture;
+    Capture *cap = NULL;
+    if (capture_path) {
+        int fbw, fbh;
+        glfwGetFramebufferSize(window, &fbw, &fbh);
+        if (capture_open(&capture, capture_path, fbw, fbh, CAPTURE_FPS)) cap = &capture;
+        else fprintf(stderr, "capture disabled\n");
+    }
+
+    /* single-threaded: one snapshot reused every frame.
+       threaded: the render thread takes over the context and its own snapshots */
+    FrameSnapshot snap = {0};
+    RenderThread rt;
+    if (threaded) {
+        glfwMakeContextCurrent(NULL);
+        if (!render_thread_start(&rt, window, &game, cap)) {
+            fprintf(stderr, "render thread failed, rendering on the main thread\n");
+            glfwMakeContextCurrent(window);
+            threaded = 0;
+        }
+    }
+    if (!threaded && !game_snapshot_alloc(&snap, &game.sim)) {
+        fprintf(stderr, "snapshot allocation failed\n");
+        game_shutdown(&game);
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+
+    /* single-threaded frames render into a persistent scene target, sized by
+       the dynamic resolution controller and scaled up on present; with damage
+       tracking they repaint only what changed and skip the redraw and swap
+       when nothing did */
+    Damage dmg;
+    DynRes dyn;
+    int use_scene = !threaded;
+    if (threaded) use_damage = 0;
+    if (use_scene) {
+        int fbw, fbh;
+        glfwGetFramebufferSize(window, &fbw, &fbh);
+        dynres_init(&dyn, target_ms, min_scale, max_scale);
+        int sw, sh;
+        dynres_size(&dyn, fbw, fbh, &sw, &sh);
+        if (!damage_init(&dmg, sw, sh)) {
+            fprintf(stderr, "scene target disabled, drawing to the window\n");
+            use_scene = use_damage = 0;
+        }
+        glfwSetWindowRefreshCallback(window, on_window_refresh);
+    }
+
+    /* CPU update/render times, joined by the GPU pass times a few frames later */
+    FrameTimeRing times;
+    frame_times_init(&times);
+
+    /* the render thread presents on its own schedule, so pacing is single-threaded only */
+    Pacer pacer;
+    if (threaded) pace = 0;
+    if (pace) {
+        const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        pacer_init(&pacer, mode ? mode->refreshRate : 60.0, PACE_MARGIN_MS);
+    }
+
+    /* the HUD is drawn over the presented frame, after the scene; the
+       render thread owns the context, so single-threaded only */
+    Hud hud;
+    int hud_fields[HUD_FIELDS];
+    if (threaded) use_hud = 0;
+    if (use_hud && (!hud_program || !hud_init(&hud, hud_program, quad.vbo, quad.ebo, HUD_SCALE) ||
+                    !hud_layout(&hud, hud_fields))) {
+        fprintf(stderr, "HUD disabled\n");
+        if (hud_program) hud_shutdown(&hud);
+        use_hud = 0;
+    }
 
     InputState inp = {0};
     double lastTime = glfwGetTime();
+    double titleTime = lastTime;
+    unsigned titleTicks = 0;
+    unsigned titleFrames = 0;
+    unsigned presentedFrames = 0;
+    double hudTime = lastTime;
+    /* real time -> fixed SIM_DT ticks; frames draw between the last two */
+    SimClock simClock;
+    sim_clock_init(&simClock);
 
     while (!glfwWindowShouldClose(window)) {
+        /* paced: sleep through the slack so input is sampled as late as the
+           next vblank allows */
+        if (pace) pacer_wait(&pacer);
+
         double now = glfwGetTime();
-        float dt = (float)(now - lastTime);
+        double dt = now - lastTime;
         lastTime = now;
 
         glfwPollEvents();
         input_poll(window, &inp);
+        double sampled = pacing_now();
         if (inp.quit) { glfwSetWindowShouldClose(window, GLFW_TRUE); break; }
 
-        game_update(&game, dt, inp.up, inp.down, inp.left, inp.right);
+        /* every tick of this frame sees the input sampled above */
+        int steps = sim_clock_advance(&simClock, dt);
+        double t_update = glfwGetTime();
+        for (int i = 0; i < steps; ++i) sim_update(&game.sim, SIM_DT, inp.up, inp.down, inp.left, inp.right);
+        float update_ms = (float)((glfwGetTime() - t_update) * 1000.0);
+        titleTicks += steps;
 
         int fbw, fbh;
         glfwGetFramebufferSize(window, &fbw, &fbh);
-        glViewport(0, 0, fbw, fbh);
-        glClear(GL_COLOR_BUFFER_BIT);
+        int present = 1;
+        int redraw = 0;
+
+        if (threaded) {
+            /* the render thread gets both ticks and blends them by the time
+               it draws; now is simClock.acc into the blend */
+            if (steps > 0) {
+                FrameSnapshot *s = render_thread_back(&rt);
+                game_snapshot(&game.sim, 1.0f, s);
+                s->blend_start = now - simClock.acc;
+                s->fb_width = fbw;
+                s->fb_height = fbh;
+                render_thread_publish(&rt);
+            }
+        } else {
+            game_snapshot(&game.sim, sim_clock_alpha(&simClock), &snap);
+            redraw = 1;
+            if (use_scene) {
+                int sw, sh;
+                dynres_size(&dyn, fbw, fbh, &sw, &sh);
+                damage_resize(&dmg, sw, sh);
+                if (use_damage) game_collect_damage(&game, &snap, &dmg);
+                else damage_all(&dmg);
+                redraw = damage_begin(&dmg);
+            } else {
+                glViewport(0, 0, fbw, fbh);
+                glClear(GL_COLOR_BUFFER_BIT);
+            }
+            if (redraw) {
+                double t_render = glfwGetTime();
+                if (use_scene) game_render_damaged(&game, &snap, &dmg);
+                else game_render(&game, &snap, fbw, fbh);
+                float render_ms = (float)((glfwGetTime() - t_render) * 1000.0);
+                frame_times_push(&times, game.timers.frame, update_ms, render_ms);
+                if (use_scene) damage_end(&dmg);
+            }
+            gpu_timers_collect(&game.timers, &times);
+
+            /* the next frame's scene size follows the recent frame cost; GPU
+               times are the passes' own, so they track the scene size */
+            if (redraw && use_scene) {
+                FrameTimeSummary ft;
+                frame_times_summary(&times, DYNRES_FRAMES, &ft);
+                dynres_update(&dyn, ft.update_ms + fmaxf(ft.render_ms, ft.gpu_ms));
+            }
 
-        glUseProgram(program);
-        game_render(&game, loc_uOffset, loc_uScale, loc_uColor);
+            /* HUD text changes are presented even when the scene did not
+               change; the counters refresh once per second */
+            int hud_changed = 0;
+            if (use_hud) {
+                char text[32];
+                snprintf(text, sizeof(text), "%6d", game.sim.pellet_count - game.sim.pellets_left);
+                hud_changed |= hud_set(&hud, hud_fields[HUD_SCORE], text);
+                if (now - hudTime >= 1.0) {
+                    FrameTimeSummary ft;
+                    frame_times_summary(&times, FRAME_TIME_HISTORY, &ft);
+                    snprintf(text, sizeof(text), "%6.0f", presentedFrames / (now - hudTime));
+                    hud_changed |= hud_set(&hud, hud_fields[HUD_FPS], text);
+                    snprintf(text, sizeof(text), "%6.2f", ft.update_ms);
+                    hud_changed |= hud_set(&hud, hud_fields[HUD_UPDATE], text);
+                    snprintf(text, sizeof(text), "%6.2f", ft.render_ms);
+                    hud_changed |= hud_set(&hud, hud_fields[HUD_RENDER], text);
+                    snprintf(text, sizeof(text), "%6.2f", ft.gpu_ms);
+                    hud_changed |= hud_set(&hud, hud_fields[HUD_GPU], text);
+                    hudTime = now;
+                    presentedFrames = 0;
+                }
+            }
 
-        glfwSwapBuffers(window);
+            /* a recording wants every frame, changed or not */
+            present = redraw || window_exposed || cap || hud_changed;
+            window_exposed = 0;
+            if (present && use_scene) damage_blit(&dmg, fbw, fbh);
+            if (present && use_hud) hud_draw(&hud, fbw, fbh);
+            if (present && cap) capture_frame(cap, fbw, fbh);
+            if (present) presentedFrames++;
+        }
+
+        /* counters, refreshed once per second */
+        if (now - titleTime >= 1.0) {
+            char title[512];
+            if (threaded) {
+                unsigned frames = atomic_load(&rt.frames);
+                snprintf(title, sizeof(title),
+                         "pman | sim %.0f Hz | render %.0f fps, %u stale | %d draw calls/frame | %d pellets"
+                         " | render %.2f, gpu %.2f ms",
+                         titleTicks / (now - titleTime), (frames - titleFrames) / (now - titleTime),
+                         atomic_load(&rt.stale_frames), atomic_load(&rt.draw_calls), game.sim.pellets_left,
+                         atomic_load(&rt.render_us) / 1000.0, atomic_load(&rt.gpu_us) / 1000.0);
+                titleFrames = frames;
+            } else {
+                snprintf(title, sizeof(title),
+                         "pman | %d draw calls/frame, %d of %d instances visible, %d redundant state changes skipped"
+                         " | %d pellets | stream %s, %llu fence waits",
+                         game.draw_calls, game.visible_instances,
+                         WORLD_DYNAMIC_SLOTS + game.sim.wall_count + game.sim.pellet_count,
+                         game.cmds.stats.redundant_skipped, game.sim.pellets_left,
+                         game.stream.persistent ? "persistent" : "orphaned",
+                         game.stream.stats.fence_waits);
+                FrameTimeSummary ft;
+                frame_times_summary(&times, FRAME_TIME_HISTORY, &ft);
+                size_t len = strlen(title);
+                snprintf(title + len, sizeof(title) - len,
+                         " | update %.2f, render %.2f, gpu %.2f ms, worst %.2f ms %s",
+                         ft.update_ms, ft.render_ms, ft.gpu_ms, ft.worst_ms, frame_bound_name(ft.worst_bound));
+                if (use_damage && dmg.stats.frames) {
+                    len = strlen(title);
+                    snprintf(title + len, sizeof(title) - len, " | redraw %.0f%% idle, %.1f%% of pixels, %.1f regions",
+                             100.0 * dmg.stats.idle / dmg.stats.frames,
+                             100.0 * dmg.stats.pixels / ((double)dmg.stats.frames * dmg.width * dmg.height),
+                             dmg.stats.partial ? (double)dmg.stats.regions / dmg.stats.partial : 0.0);
+                }
+                if (use_scene) {
+                    len = strlen(title);
+                    snprintf(title + len, sizeof(title) - len, " | res %.0f%%, %llu changes",
+                             100.0 * dyn.scale, dyn.changes);
+                }
+                if (ft.latency_ms > 0.0f) {
+                    len = strlen(title);
+                    snprintf(title + len, sizeof(title) - len, " | input->present %.1f ms, max %.1f",
+                             ft.latency_ms, ft.latency_max_ms);
+                    if (pace) {
+                        len = strlen(title);
+                        snprintf(title + len, sizeof(title) - len, " (paced, %llu missed)", pacer.missed);
+                    }
+                }
+                if (cap && cap->stats.frames) {
+                    len = strlen(title);
+                    snprintf(title + len, sizeof(title) - len, " | capture %.2f ms/frame, %llu dropped",
+                             cap->stats.main_seconds * 1000.0 / cap->stats.frames, cap->stats.dropped);
+                }
+            }
+            glfwSetWindowTitle(window, title);
+            titleTime = now;
+            titleTicks = 0;
+        }
+
+        if (threaded) {
+            /* presenting is the render thread's job; just pace the simulation */
+            double wait = 1.0 / SIM_HZ - (glfwGetTime() - now);
+            if (wait > 0.0) glfwWaitEventsTimeout(wait);
+        } else if (present) {
+            double submitted = pacing_now();
+            glfwSwapBuffers(window);
+            /* paced: wait for the flip, so the swap's return marks the vblank */
+            if (pace) glFinish();
+            double presented = pacing_now();
+            if (pace) pacer_presented(&pacer, sampled, submitted, presented);
+            if (redraw) frame_times_set_latency(&times, game.timers.frame, (float)((presented - sampled) * 1000.0));
+        } else {
+            /* nothing changed: sleep until input arrives or a frame would be due */
+            glfwWaitEventsTimeout(IDLE_WAIT);
+        }
+    }
+
+    if (threaded) {
+        render_thread_stop(&rt);
+        glfwMakeContextCurrent(window);
+    } else {
+        game_snapshot_free(&snap);
+        if (use_scene) damage_shutdown(&dmg);
+        if (pace) pacer_shutdown(&pacer);
+        if (use_hud) hud_shutdown(&hud);
+    }
+    if (cap) {
+        capture_close(cap);
+        printf("capture: %llu frames written, %llu dropped, %.3f ms/frame on the GL thread\n",
+               cap->stats.written, cap->stats.dropped,
+               cap->stats.frames ? cap->stats.main_seconds * 1000.0 / cap->stats.frames : 0.0);
     }
 
     game_shutdown(&game);
 
     /* cleanup GL objects */
     glDeleteProgram(program);
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    if (board_program) glDeleteProgram(board_program);
+    if (hud_program) glDeleteProgram(hud_program);
+    if (sprite_program) glDeleteProgram(sprite_program);
+    gfx_destroy_quad(&quad);
 
     glfwDestroyWindow(window);
     glfwTerminate();
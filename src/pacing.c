@@ -0,0 +1,85 @@
+// src/pacing.c
+#include "pacing.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/* the last stretch of every wait is spun rather than slept */
+#define PACING_SPIN 0.002
+
+double pacing_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void pacing_sleep_until(double t)
+{
+    double left = t - pacing_now();
+    if (left > PACING_SPIN) {
+        double s = left - PACING_SPIN;
+        struct timespec ts;
+        ts.tv_sec = (time_t)s;
+        ts.tv_nsec = (long)((s - (double)ts.tv_sec) * 1e9);
+        nanosleep(&ts, NULL);
+    }
+    while (pacing_now() < t) {
+        /* spin */
+    }
+}
+
+void pacer_init(Pacer *p, double refresh_hz, double margin_ms)
+{
+    memset(p, 0, sizeof(*p));
+    p->period = 1.0 / (refresh_hz > 0.0 ? refresh_hz : 60.0);
+    p->margin = margin_ms * 0.001;
+#ifdef _WIN32
+    /* default timer resolution would make every sleep overshoot by up to 15.6 ms */
+    timeBeginPeriod(1);
+#endif
+}
+
+void pacer_shutdown(Pacer *p)
+{
+    (void)p;
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+static double work_estimate(const Pacer *p)
+{
+    /* worst recent frame: a deadline missed costs a whole refresh, sleeping
+       a little too short costs only a little latency */
+    double w = 0.0;
+    for (int i = 0; i < p->work_count; ++i) if (p->work[i] > w) w = p->work[i];
+    return w + p->margin;
+}
+
+void pacer_wait(Pacer *p)
+{
+    if (p->last_present <= 0.0) return;
+    double now = pacing_now();
+    double need = work_estimate(p);
+
+    /* first vblank we can still make, on the phase of the last completed swap */
+    double n = ceil((now + need - p->last_present) / p->period);
+    if (n < 1.0) n = 1.0;
+    p->target = p->last_present + n * p->period;
+    pacing_sleep_until(p->target - need);
+}
+
+void pacer_presented(Pacer *p, double sampled, double submitted, double presented)
+{
+    p->work[p->work_next] = submitted - sampled;
+    p->work_next = (p->work_next + 1) % PACER_HISTORY;
+    if (p->work_count < PACER_HISTORY) p->work_count++;
+
+    p->frames++;
+    if (p->target > 0.0 && presented > p->target + 0.5 * p->period) p->missed++;
+    p->last_present = presented;
+}
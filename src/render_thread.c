@@ -0,0 +1,108 @@
+// src/render_thread.c
+#include "render_thread.h"
+#include <stdio.h>
+
+static void *render_main(void *arg)
+{
+    RenderThread *rt = (RenderThread*)arg;
+    glfwMakeContextCurrent(rt->window);
+
+    /* render_thread_start publishes before creating us, so the first acquire
+       always yields a snapshot */
+    unsigned long long last_tick = 0;
+    int first = 1;
+    while (!atomic_load(&rt->quit)) {
+        triple_acquire(&rt->snapshots);
+        const FrameSnapshot *s = &rt->slots[triple_front(&rt->snapshots)];
+
+        if (!first && s->tick == last_tick) atomic_fetch_add(&rt->stale_frames, 1);
+        last_tick = s->tick;
+        first = 0;
+
+        /* blend the snapshot's two ticks by how far real time is past the
+           last one, as the single-threaded loop does with sim_clock_alpha;
+           redraws of a stale snapshot keep moving until they reach it */
+        FrameSnapshot view;
+        float alpha = s->blend_start > 0.0 ? (float)((glfwGetTime() - s->blend_start) * SIM_HZ) : 1.0f;
+        game_snapshot_blend(s, alpha < 0.0f ? 0.0f : alpha > 1.0f ? 1.0f : alpha, &view);
+
+        glViewport(0, 0, s->fb_width, s->fb_height);
+        glClear(GL_COLOR_BUFFER_BIT);
+        double t_render = glfwGetTime();
+        game_render(rt->game, &view, s->fb_width, s->fb_height);
+        frame_times_push(&rt->times, rt->game->timers.frame, 0.0f, (float)((glfwGetTime() - t_render) * 1000.0));
+        atomic_store(&rt->draw_calls, rt->game->draw_calls);
+
+        /* the timer queries are this context's, so only this thread can read
+           them back */
+        FrameTimeSummary ft;
+        gpu_timers_collect(&rt->game->timers, &rt->times);
+        frame_times_summary(&rt->times, FRAME_TIME_HISTORY, &ft);
+        atomic_store(&rt->render_us, (unsigned)(ft.render_ms * 1000.0f));
+        atomic_store(&rt->gpu_us, (unsigned)(ft.gpu_ms * 1000.0f));
+        if (rt->capture) capture_frame(rt->capture, s->fb_width, s->fb_height);
+
+        glfwSwapBuffers(rt->window);
+        atomic_fetch_add(&rt->frames, 1);
+    }
+
+    glfwMakeContextCurrent(NULL);
+    return NULL;
+}
+
+int render_thread_start(RenderThread *rt, GLFWwindow *window, Game *game, Capture *capture)
+{
+    rt->window = window;
+    rt->game = game;
+    rt->capture = capture;
+    rt->running = 0;
+    atomic_init(&rt->quit, 0);
+    atomic_init(&rt->frames, 0);
+    atomic_init(&rt->stale_frames, 0);
+    atomic_init(&rt->draw_calls, 0);
+    atomic_init(&rt->render_us, 0);
+    atomic_init(&rt->gpu_us, 0);
+    frame_times_init(&rt->times);
+    triple_init(&rt->snapshots);
+
+    for (int i = 0; i < 3; ++i) {
+        if (!game_snapshot_alloc(&rt->slots[i], &game->sim)) {
+            for (int j = 0; j < i; ++j) game_snapshot_free(&rt->slots[j]);
+            return 0;
+        }
+    }
+
+    /* publish the current state so the thread has something to draw at once */
+    FrameSnapshot *first = render_thread_back(rt);
+    game_snapshot(&game->sim, 1.0f, first);
+    first->blend_start = 0.0;
+    glfwGetFramebufferSize(window, &first->fb_width, &first->fb_height);
+    render_thread_publish(rt);
+
+    if (pthread_create(&rt->thread, NULL, render_main, rt) != 0) {
+        fprintf(stderr, "render_thread_start: pthread_create failed\n");
+        for (int i = 0; i < 3; ++i) game_snapshot_free(&rt->slots[i]);
+        return 0;
+    }
+    rt->running = 1;
+    return 1;
+}
+
+FrameSnapshot *render_thread_back(RenderThread *rt)
+{
+    return &rt->slots[triple_back(&rt->snapshots)];
+}
+
+void render_thread_publish(RenderThread *rt)
+{
+    triple_publish(&rt->snapshots);
+}
+
+void render_thread_stop(RenderThread *rt)
+{
+    if (!rt->running) return;
+    atomic_store(&rt->quit, 1);
+    pthread_join(rt->thread, NULL);
+    rt->running = 0;
+    for (int i = 0; i < 3; ++i) game_snapshot_free(&rt->slots[i]);
+}
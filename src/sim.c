@@ -0,0 +1,583 @@
+// src/sim.c
+#include "sim.h"
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* edge of a wall/pellet grid cell, world units; a screen is 8x8 cells */
+#define SIM_GRID_CELL 0.25f
+
+/* half extents of the visible rectangle, world units */
+#define SIM_VIEW_HALF 1.0f
+
+/* ghost speed as a fraction of the player's */
+#define GHOST_SPEED_NORMAL 0.8f
+
+/* a wanderer (ghost or autopilot) turns after this many ticks on average
+   even when not blocked */
+#define WANDER_TURN_TICKS 90
+
+/* SIM_DT for the clock's double arithmetic, so 1/60 s is exactly two ticks */
+#define SIM_STEP_SECONDS (1.0 / SIM_HZ)
+
+/* wrapper: accepts stored half-values and applies scale factors per object before testing */
+static int rects_overlap_with_scales(float ax, float ay, float aStoredHalfX, float aStoredHalfY,
+                                     float bx, float by, float bStoredHalfX, float bStoredHalfY,
+                                     float aScaleX, float aScaleY, float bScaleX, float bScaleY)
+{
+    /* compute actual visual half-extents used for rendering */
+    float aVisHalfX = aStoredHalfX * aScaleX * 0.5f;
+    float aVisHalfY = aStoredHalfY * aScaleY * 0.5f;
+    float bVisHalfX = bStoredHalfX * bScaleX * 0.5f;
+    float bVisHalfY = bStoredHalfY * bScaleY * 0.5f;
+
+    return (fabsf(ax - bx) < (aVisHalfX + bVisHalfX)) &&
+           (fabsf(ay - by) < (aVisHalfY + bVisHalfY));
+}
+
+/* any wall overlapping a box of stored half size half at (x, y), drawn with
+   the given scales; only the walls binned under the box are tested, a grid
+   row of cells at a time since their boxes are one run of wall_boxes */
+static int hits_wall(const Sim *s, float x, float y, float half, float scale_x, float scale_y)
+{
+    float hx = half * scale_x * 0.5f, hy = half * scale_y * 0.5f;
+    int cx0, cy0, cx1, cy1;
+    if (!grid_bins_query(&s->wall_bins, x - hx, y - hy, x + hx, y + hy, &cx0, &cy0, &cx1, &cy1)) return 0;
+    for (int row = cy0; row <= cy1; ++row) {
+        int c = row * s->wall_bins.cols;
+        if (collide_any(&s->wall_boxes, s->wall_bins.start[c + cx0], s->wall_bins.start[c + cx1 + 1],
+                        x, y, hx, hy))
+            return 1;
+    }
+    return 0;
+}
+
+/* dynamic pellet array helpers */
+static int append_pellet(Sim *s, float x, float y, float r) {
+    Pellet *tmp = (Pellet*)realloc(s->pellets, (s->pellet_count + 1) * sizeof(Pellet));
+    if (!tmp) return 0;
+    s->pellets = tmp;
+    s->pellets[s->pellet_count].x = x;
+    s->pellets[s->pellet_count].y = y;
+    s->pellets[s->pellet_count].r = r;
+    s->pellet_count++;
+    return 1;
+}
+
+int sim_pellet_alive_bytes(const Sim *s) { return (s->pellet_count + 7) / 8; }
+
+static int pellet_cell(const Sim *s, int idx)
+{
+    return grid_cell_of(&s->pellet_grid, s->pellets[idx].x, s->pellets[idx].y);
+}
+
+/* lattice column / row of a world position, unclamped */
+static int lattice_col(const Sim *s, float x) { return (int)floorf((x - s->lattice_x) / s->lattice_spacing); }
+static int lattice_row(const Sim *s, float y) { return (int)floorf((y - s->lattice_y) / s->lattice_spacing); }
+
+/* lattice cell of pellet slot idx; pellets sit on cell centres, so rounding
+   never moves one across a cell edge */
+static int pellet_lattice_cell(const Sim *s, int idx)
+{
+    return lattice_row(s, s->pellets[idx].y) * s->lattice_cols + lattice_col(s, s->pellets[idx].x);
+}
+
+/* point every lattice cell at the slot its pellet is in now */
+static int build_lattice_index(Sim *s)
+{
+    int cells = s->lattice_cols * s->lattice_rows;
+    int *slot = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+    if (!slot) return 0;
+    for (int c = 0; c < cells; ++c) slot[c] = -1;
+    for (int i = 0; i < s->pellet_count; ++i) slot[pellet_lattice_cell(s, i)] = i;
+    free(s->lattice_pellet);
+    s->lattice_pellet = slot;
+    return 1;
+}
+
+int sim_pellet_alive(const Sim *s, int idx)
+{
+    if (idx < 0 || idx >= s->pellet_count) return 0;
+    if (s->pellet_storage == PELLETS_BITMASK) return (s->pellet_alive[idx >> 3] >> (idx & 7)) & 1;
+    int c = pellet_cell(s, idx);
+    return idx < s->pellet_grid.start[c] + s->pellet_live[c];
+}
+
+/* alive bits and pellets_left from whatever the current storage says is alive */
+static int rebuild_pellet_alive(Sim *s)
+{
+    int bytes = sim_pellet_alive_bytes(s);
+    unsigned char *bits = (unsigned char*)calloc((size_t)(bytes > 0 ? bytes : 1), 1);
+    if (!bits) return 0;
+    int left = 0;
+    for (int i = 0; i < s->pellet_count; ++i) {
+        if (!sim_pellet_alive(s, i)) continue;
+        bits[i >> 3] |= (unsigned char)(1u << (i & 7));
+        left++;
+    }
+    free(s->pellet_alive);
+    s->pellet_alive = bits;
+    s->pellets_left = left;
+    return 1;
+}
+
+/* mark every pellet of the current array alive */
+static int reset_pellet_alive(Sim *s)
+{
+    int cells = s->pellet_grid.cols * s->pellet_grid.rows;
+    int *live = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+    if (!live) return 0;
+    for (int c = 0; c < cells; ++c) live[c] = s->pellet_grid.start[c + 1] - s->pellet_grid.start[c];
+    free(s->pellet_live);
+    s->pellet_live = live;
+
+    int bytes = sim_pellet_alive_bytes(s);
+    unsigned char *bits = (unsigned char*)calloc((size_t)(bytes > 0 ? bytes : 1), 1);
+    if (!bits) return 0;
+    for (int i = 0; i < s->pellet_count; ++i) bits[i >> 3] |= (unsigned char)(1u << (i & 7));
+    free(s->pellet_alive);
+    s->pellet_alive = bits;
+    s->pellets_left = s->pellet_count;
+    return 1;
+}
+
+static void remove_pellet(Sim *s, int idx) {
+    if (idx < 0 || idx >= s->pellet_count) return;
+    if (s->pellet_storage == PELLETS_BITMASK) {
+        /* positions never move: clear the bit; renderers diff the bits */
+        int byte = idx >> 3;
+        if (!((s->pellet_alive[byte] >> (idx & 7)) & 1)) return;
+        s->pellet_alive[byte] &= (unsigned char)~(1u << (idx & 7));
+        s->pellets_left--;
+        return;
+    }
+    /* swap with the cell's last live pellet so the cell range stays
+       [live | eaten] and the grid offsets never change */
+    int c = pellet_cell(s, idx);
+    int last = s->pellet_grid.start[c] + s->pellet_live[c] - 1;
+    if (idx > last) return;
+    if (idx != last) {
+        Pellet eaten = s->pellets[idx];
+        s->pellets[idx] = s->pellets[last];
+        s->pellets[last] = eaten;
+        s->lattice_pellet[pellet_lattice_cell(s, idx)] = idx;
+        s->lattice_pellet[pellet_lattice_cell(s, last)] = last;
+    }
+    s->pellet_live[c]--;
+    s->pellets_left--;
+    if (s->pellet_moved) {
+        if (idx != last) s->pellet_moved(s->user, idx);
+        s->pellet_moved(s->user, last);
+    }
+}
+
+/* Generate pellets on a lattice over the level bounds. For each candidate we
+   check overlap using the SCALED visual half-extents so pellets never overlap
+   walls. pellet_radius parameter is the stored r. Lattice points are spacing
+   apart, which is wider than two pellets, so pellets cannot overlap each other.
+*/
+static void generate_pellets(Sim *s,
+                             float pellet_radius,
+                             float spacing,
+                             float margin,
+                             float avoid_x, float avoid_y, float avoid_radius)
+{
+    float maxX = s->max_x - margin;
+    float maxY = s->max_y - margin;
+
+    float startX = s->min_x + margin + spacing * 0.5f;
+    float startY = s->min_y + margin + spacing * 0.5f;
+
+    s->lattice_x = s->min_x + margin;
+    s->lattice_y = s->min_y + margin;
+    s->lattice_spacing = spacing;
+    s->lattice_cols = s->lattice_rows = 0;
+
+    for (float y = startY; y <= maxY + 1e-6f; y += spacing) {
+        s->lattice_rows++;
+        s->lattice_cols = 0;
+        for (float x = startX; x <= maxX + 1e-6f; x += spacing) {
+            s->lattice_cols++;
+            // keep clear around player start
+            float dx = x - avoid_x, dy = y - avoid_y;
+            float avoidDist = avoid_radius + pellet_radius;
+            if (dx*dx + dy*dy < (avoidDist * avoidDist)) continue;
+
+            // check overlap with walls (use scaled visuals)
+            if (hits_wall(s, x, y, pellet_radius, PELLET_SCALE_X, PELLET_SCALE_Y)) continue;
+
+            if (!append_pellet(s, x, y, pellet_radius)) {
+                fprintf(stderr, "generate_pellets: allocation failed\n");
+                return;
+            }
+        }
+    }
+}
+
+/* reorder every pellet cell into [alive | eaten] by the alive bits,
+   keeping the survivors in order */
+static int squeeze_pellets(Sim *s)
+{
+    Pellet *out = (Pellet*)malloc(sizeof(Pellet) * (s->pellet_count > 0 ? s->pellet_count : 1));
+    if (!out) return 0;
+    int cells = s->pellet_grid.cols * s->pellet_grid.rows;
+    for (int c = 0; c < cells; ++c) {
+        int first = s->pellet_grid.start[c], end = s->pellet_grid.start[c + 1];
+        int n = first;
+        for (int i = first; i < end; ++i) if (sim_pellet_alive(s, i)) out[n++] = s->pellets[i];
+        s->pellet_live[c] = n - first;
+        for (int i = first; i < end; ++i) if (!sim_pellet_alive(s, i)) out[n++] = s->pellets[i];
+    }
+    free(s->pellets);
+    s->pellets = out;
+    return build_lattice_index(s);
+}
+
+int sim_set_pellet_storage(Sim *s, PelletStorage mode)
+{
+    if (!s || mode == s->pellet_storage) return 1;
+
+    if (mode == PELLETS_COMPACT) {
+        if (!squeeze_pellets(s)) return 0;
+        s->pellet_storage = mode;
+    }
+    /* bits from the live counts when going to BITMASK, refreshed after the
+       squeeze when going to COMPACT */
+    if (!rebuild_pellet_alive(s)) return 0;
+    s->pellet_storage = mode;
+    return 1;
+}
+
+/* rebuild grid over n items and apply its cell order to data (elem bytes each) */
+static int sort_by_grid(Sim *s, Grid *gr, const GridItem *items, void *data, size_t elem, int n)
+{
+    int *order = (int*)malloc(sizeof(int) * (n > 0 ? n : 1));
+    unsigned char *tmp = (unsigned char*)malloc(elem * (n > 0 ? n : 1));
+    grid_free(gr);
+    if (!order || !tmp ||
+        !grid_build(gr, s->min_x, s->min_y, s->max_x, s->max_y, SIM_GRID_CELL, items, n, order)) {
+        free(order); free(tmp);
+        return 0;
+    }
+    for (int i = 0; i < n; ++i) memcpy(tmp + elem * i, (unsigned char*)data + elem * order[i], elem);
+    memcpy(data, tmp, elem * n);
+    free(order); free(tmp);
+    return 1;
+}
+
+/* a grid item for the drawn box of every wall */
+static GridItem *wall_items(const Sim *s)
+{
+    GridItem *items = (GridItem*)malloc(sizeof(GridItem) * (s->wall_count > 0 ? s->wall_count : 1));
+    if (!items) return NULL;
+    for (int i = 0; i < s->wall_count; ++i) {
+        items[i].x = s->walls[i].x; items[i].y = s->walls[i].y;
+        items[i].hx = s->walls[i].halfW * WALL_SCALE_X * 0.5f;
+        items[i].hy = s->walls[i].halfH * WALL_SCALE_Y * 0.5f;
+    }
+    return items;
+}
+
+/* walls into grid cell order, then binned for collisions with their boxes
+   copied out bin by bin; pellets come later */
+static int build_wall_grids(Sim *s)
+{
+    GridItem *items = wall_items(s);
+    if (!items) return 0;
+    int ok = sort_by_grid(s, &s->wall_grid, items, s->walls, sizeof(Rect), s->wall_count);
+    free(items);
+    items = ok ? wall_items(s) : NULL;
+    grid_bins_free(&s->wall_bins);
+    ok = items && grid_bins_build(&s->wall_bins, s->min_x, s->min_y, s->max_x, s->max_y, SIM_GRID_CELL,
+                                  items, s->wall_count);
+    int binned = ok ? s->wall_bins.start[s->wall_bins.cols * s->wall_bins.rows] : 0;
+    ok = ok && collide_boxes_resize(&s->wall_boxes, binned);
+    for (int k = 0; ok && k < binned; ++k) {
+        const GridItem *w = &items[s->wall_bins.items[k]];
+        collide_boxes_set(&s->wall_boxes, k, w->x, w->y, w->hx, w->hy);
+    }
+    free(items);
+    return ok;
+}
+
+/* grid over the drawn pellet boxes, see the *_SCALE_* in sim.h */
+static int build_pellet_grid(Sim *s)
+{
+    GridItem *items = (GridItem*)malloc(sizeof(GridItem) * (s->pellet_count > 0 ? s->pellet_count : 1));
+    if (!items) return 0;
+    for (int i = 0; i < s->pellet_count; ++i) {
+        items[i].x = s->pellets[i].x; items[i].y = s->pellets[i].y;
+        items[i].hx = s->pellets[i].r * PELLET_SCALE_X * 0.5f;
+        items[i].hy = s->pellets[i].r * PELLET_SCALE_Y * 0.5f;
+    }
+    int ok = sort_by_grid(s, &s->pellet_grid, items, s->pellets, sizeof(Pellet), s->pellet_count);
+    free(items);
+    return ok && build_lattice_index(s);
+}
+
+/* moves an actor of the player's size by (dx, dy), each axis separately so
+   it slides along walls, and keeps it inside the level */
+static void move_actor(const Sim *s, float *x, float *y, float dx, float dy)
+{
+    /* attempt X movement: check against walls using visual scaled halves */
+    float newX = *x + dx;
+    if (!hits_wall(s, newX, *y, s->half, PLAYER_SCALE_X, PLAYER_SCALE_Y)) *x = newX;
+
+    /* attempt Y movement */
+    float newY = *y + dy;
+    if (!hits_wall(s, *x, newY, s->half, PLAYER_SCALE_X, PLAYER_SCALE_Y)) *y = newY;
+
+    /* clamp to the level */
+    if (*x > s->max_x - s->half) *x = s->max_x - s->half;
+    if (*x < s->min_x + s->half) *x = s->min_x + s->half;
+    if (*y > s->max_y - s->half) *y = s->max_y - s->half;
+    if (*y < s->min_y + s->half) *y = s->min_y + s->half;
+}
+
+static unsigned xorshift(unsigned *rng)
+{
+    *rng ^= *rng << 13;
+    *rng ^= *rng >> 17;
+    *rng ^= *rng << 5;
+    return *rng;
+}
+
+/* the FACE_* a wanderer walks next: dir until it stops moving, or at random */
+static int wander(unsigned *rng, int dir, int blocked)
+{
+    if (blocked || xorshift(rng) % WANDER_TURN_TICKS == 0) return (int)(xorshift(rng) % 4);
+    return dir;
+}
+
+/* each ghost keeps walking its way until it stops moving, or at random */
+static void update_ghosts(Sim *s, float dt)
+{
+    float step = s->speed * GHOST_SPEED_NORMAL * dt;
+    for (int i = 0; i < s->ghost_count; ++i) {
+        GameGhost *gh = &s->ghosts[i];
+        float x = gh->x, y = gh->y;
+        float dx = gh->dir == FACE_RIGHT ? step : gh->dir == FACE_LEFT ? -step : 0.0f;
+        float dy = gh->dir == FACE_UP ? step : gh->dir == FACE_DOWN ? -step : 0.0f;
+        move_actor(s, &gh->x, &gh->y, dx, dy);
+        gh->dir = wander(&s->ghost_rng, gh->dir, gh->x == x && gh->y == y);
+    }
+}
+
+/* all ghosts start on the player's start, each walking its own way */
+static void reset_ghosts(Sim *s, float x, float y)
+{
+    static const float colors[GAME_GHOSTS][3] = {
+        { 1.0f, 0.0f, 0.0f },    // red
+        { 1.0f, 0.72f, 1.0f },   // pink
+        { 0.0f, 1.0f, 1.0f },    // cyan
+        { 1.0f, 0.72f, 0.32f },  // orange
+    };
+    s->ghost_rng = 0x9E3779B9u;
+    for (int i = 0; i < GAME_GHOSTS; ++i) {
+        GameGhost *gh = &s->ghosts[i];
+        gh->x = gh->px = x;
+        gh->y = gh->py = y;
+        gh->dir = i % 4;
+        gh->r = colors[i][0]; gh->g = colors[i][1]; gh->b = colors[i][2];
+    }
+}
+
+static float follow(float pos, float lo, float hi, float view_half)
+{
+    if (hi - lo <= 2.0f * view_half) return 0.5f * (lo + hi);
+    if (pos < lo + view_half) return lo + view_half;
+    if (pos > hi - view_half) return hi - view_half;
+    return pos;
+}
+
+static void update_camera(Sim *s)
+{
+    s->camX = follow(s->posX, s->min_x, s->max_x, s->viewHalfX);
+    s->camY = follow(s->posY, s->min_y, s->max_y, s->viewHalfY);
+}
+
+Rect sim_wall_from_box(float cx, float cy, float vis_hx, float vis_hy)
+{
+    Rect r;
+    r.x = cx; r.y = cy;
+    r.halfW = vis_hx * 2.0f / WALL_SCALE_X;
+    r.halfH = vis_hy * 2.0f / WALL_SCALE_Y;
+    return r;
+}
+
+int sim_load_level(Sim *s, const Level *lv)
+{
+    if (!s || !lv || lv->wall_count < 0 || (lv->wall_count > 0 && !lv->walls)) return 0;
+
+    Rect *copy = NULL;
+    if (lv->wall_count > 0) {
+        copy = (Rect*)malloc(sizeof(Rect) * lv->wall_count);
+        if (!copy) return 0;
+        for (int i = 0; i < lv->wall_count; ++i) copy[i] = lv->walls[i];
+    }
+    free(s->walls);
+    s->walls = copy;
+    s->wall_count = lv->wall_count;
+    s->min_x = lv->min_x; s->max_x = lv->max_x;
+    s->min_y = lv->min_y; s->max_y = lv->max_y;
+    s->posX = s->prevX = lv->start_x;
+    s->posY = s->prevY = lv->start_y;
+    s->facing = FACE_RIGHT;
+    update_camera(s);
+    s->prevCamX = s->camX;
+    s->prevCamY = s->camY;
+    reset_ghosts(s, lv->start_x, lv->start_y);
+
+    free(s->pellets);
+    s->pellets = NULL;
+    s->pellet_count = 0;
+
+    /* auto-generate pellets with parameters tuned to fill corridors */
+    float pellet_radius = 0.02f;  /* stored pellet.r unchanged */
+    float spacing = 0.05f;        /* dense */
+    float margin = 0.03f;
+    float avoid_radius = 0.14f;
+
+    if (!build_wall_grids(s)) {
+        fprintf(stderr, "sim_load_level: level allocation failed\n");
+        return 0;
+    }
+    generate_pellets(s, pellet_radius, spacing, margin, s->posX, s->posY, avoid_radius);
+    s->pellet_radius = pellet_radius;
+
+    if (!build_pellet_grid(s) || !reset_pellet_alive(s)) {
+        fprintf(stderr, "sim_load_level: level allocation failed\n");
+        return 0;
+    }
+    return 1;
+}
+
+int sim_init(Sim *s)
+{
+    if (!s) return 0;
+    memset(s, 0, sizeof(*s));
+    s->pellet_storage = PELLETS_COMPACT;
+    collide_boxes_init(&s->wall_boxes);
+
+    /* player (keep stored size identical) */
+    s->half = 0.05f;
+    s->speed = 1.2f;
+    s->facing = FACE_RIGHT;
+    s->viewHalfX = s->viewHalfY = SIM_VIEW_HALF;
+    return 1;
+}
+
+void sim_set_ghost_count(Sim *s, int count)
+{
+    s->ghost_count = count < 0 ? 0 : count > GAME_GHOSTS ? GAME_GHOSTS : count;
+}
+
+void sim_update(Sim *s, float dt, int up, int down, int left, int right)
+{
+    s->tick++;
+    s->time += dt;
+    s->prevX = s->posX;
+    s->prevY = s->posY;
+    s->prevCamX = s->camX;
+    s->prevCamY = s->camY;
+    for (int i = 0; i < GAME_GHOSTS; ++i) {
+        s->ghosts[i].px = s->ghosts[i].x;
+        s->ghosts[i].py = s->ghosts[i].y;
+    }
+
+    float dx = 0.0f, dy = 0.0f;
+    if (left)  dx -= s->speed * dt;
+    if (right) dx += s->speed * dt;
+    if (up)     dy += s->speed * dt;
+    if (down)   dy -= s->speed * dt;
+    if (left)  s->facing = FACE_LEFT;
+    if (right) s->facing = FACE_RIGHT;
+    if (up)    s->facing = FACE_UP;
+    if (down)  s->facing = FACE_DOWN;
+
+    move_actor(s, &s->posX, &s->posY, dx, dy);
+    update_camera(s);
+    update_ghosts(s, dt);
+
+    /* pellet-eating: remove pellet if overlapping (use scaled visuals for both).
+       Only the lattice cells whose pellet could touch the player are looked at,
+       a handful however big the level; compact swaps move slots, not lattice
+       cells, so every pellet under the player is still visited once. */
+    float reach_x = s->half * PLAYER_SCALE_X * 0.5f + s->pellet_radius * PELLET_SCALE_X * 0.5f;
+    float reach_y = s->half * PLAYER_SCALE_Y * 0.5f + s->pellet_radius * PELLET_SCALE_Y * 0.5f;
+    int cx0 = lattice_col(s, s->posX - reach_x), cx1 = lattice_col(s, s->posX + reach_x);
+    int cy0 = lattice_row(s, s->posY - reach_y), cy1 = lattice_row(s, s->posY + reach_y);
+    if (cx0 < 0) cx0 = 0;
+    if (cy0 < 0) cy0 = 0;
+    if (cx1 > s->lattice_cols - 1) cx1 = s->lattice_cols - 1;
+    if (cy1 > s->lattice_rows - 1) cy1 = s->lattice_rows - 1;
+    for (int row = cy0; row <= cy1; ++row) {
+        for (int col = cx0; col <= cx1; ++col) {
+            int i = s->lattice_pellet[row * s->lattice_cols + col];
+            if (i < 0 || !sim_pellet_alive(s, i)) continue;
+            if (rects_overlap_with_scales(s->posX, s->posY,
+                                          s->half, s->half,
+                                          s->pellets[i].x, s->pellets[i].y, s->pellets[i].r, s->pellets[i].r,
+                                          PLAYER_SCALE_X, PLAYER_SCALE_Y,
+                                          PELLET_SCALE_X, PELLET_SCALE_Y)) {
+                remove_pellet(s, i);
+            }
+        }
+    }
+}
+
+void sim_autopilot_init(SimPilot *p, unsigned seed, int dir)
+{
+    p->rng = seed ? seed : 1;
+    p->dir = dir;
+    p->last_x = p->last_y = 0.0f;
+}
+
+void sim_autopilot_step(SimPilot *p, Sim *s, float dt)
+{
+    p->dir = wander(&p->rng, p->dir, s->posX == p->last_x && s->posY == p->last_y);
+    p->last_x = s->posX;
+    p->last_y = s->posY;
+    sim_update(s, dt, p->dir == FACE_UP, p->dir == FACE_DOWN, p->dir == FACE_LEFT, p->dir == FACE_RIGHT);
+}
+
+void sim_shutdown(Sim *s)
+{
+    if (!s) return;
+    free(s->walls); s->walls = NULL;
+    free(s->pellets); s->pellets = NULL;
+    free(s->pellet_alive); s->pellet_alive = NULL;
+    free(s->pellet_live); s->pellet_live = NULL;
+    free(s->lattice_pellet); s->lattice_pellet = NULL;
+    grid_free(&s->wall_grid);
+    grid_free(&s->pellet_grid);
+    grid_bins_free(&s->wall_bins);
+    collide_boxes_free(&s->wall_boxes);
+}
+
+void sim_clock_init(SimClock *c)
+{
+    c->acc = 0.0;
+    c->dropped = 0;
+}
+
+int sim_clock_advance(SimClock *c, double dt)
+{
+    if (dt > 0.0) c->acc += dt;
+    int steps = (int)(c->acc / SIM_STEP_SECONDS);
+    if (steps > SIM_MAX_STEPS) {
+        /* too far behind to catch up: run what the cap allows, keep the phase */
+        c->dropped += (unsigned long long)(steps - SIM_MAX_STEPS);
+        c->acc -= (double)(steps - SIM_MAX_STEPS) * SIM_STEP_SECONDS;
+        steps = SIM_MAX_STEPS;
+    }
+    c->acc -= (double)steps * SIM_STEP_SECONDS;
+    return steps;
+}
+
+float sim_clock_alpha(const SimClock *c)
+{
+    float a = (float)(c->acc / SIM_STEP_SECONDS);
+    return a < 0.0f ? 0.0f : a >= 1.0f ? 0.999999f : a;
+}
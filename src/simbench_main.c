@@ -0,0 +1,125 @@
+// src/simbench_main.c
+// Simulation benchmark: steps bare sims (sim.h) with wandering autopilots as
+// fast as the CPU allows. No GL, no window system; links against the sim
+// library only.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "level.h"
+#include "sim.h"
+
+static double seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* FNV-1a over the state a run ends in; equal runs print equal digests */
+static unsigned long long digest(const Sim *s, unsigned long long h)
+{
+    float f[2 + 2 * GAME_GHOSTS];
+    f[0] = s->posX; f[1] = s->posY;
+    for (int i = 0; i < GAME_GHOSTS; ++i) { f[2 + 2 * i] = s->ghosts[i].x; f[3 + 2 * i] = s->ghosts[i].y; }
+    const unsigned char *b = (const unsigned char*)f;
+    for (size_t i = 0; i < sizeof(f); ++i) h = (h ^ b[i]) * 1099511628211ull;
+    for (int i = 0; i < sim_pellet_alive_bytes(s); ++i) {
+        unsigned char alive = 0;
+        for (int k = 0; k < 8 && i * 8 + k < s->pellet_count; ++k)
+            alive |= (unsigned char)(sim_pellet_alive(s, i * 8 + k) << k);
+        h = (h ^ alive) * 1099511628211ull;
+    }
+    return h;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--ticks N] [--games N] [--maze WxH[,seed]] [--pellet-bitmask]\n"
+            "          [--ghosts] [--collide scalar|sse2|avx2]\n"
+            "  runs N ticks of every game at the fixed %d Hz step, each with its own autopilot;\n"
+            "  --collide forces a wall collision kernel instead of the CPU's widest\n",
+            argv0, SIM_HZ);
+}
+
+int main(int argc, char **argv)
+{
+    long long ticks = 1000000;
+    int game_count = 1;
+    const char *maze = NULL;
+    PelletStorage pellet_storage = PELLETS_COMPACT;
+    int ghosts = 0;
+    int kernel = -1;   // -1 = each sim's own pick
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--pellet-bitmask") == 0) { pellet_storage = PELLETS_BITMASK; continue; }
+        if (strcmp(a, "--ghosts") == 0) { ghosts = GAME_GHOSTS; continue; }
+        if (!v) { usage(argv[0]); return EXIT_FAILURE; }
+        if (strcmp(a, "--ticks") == 0) ticks = atoll(v);
+        else if (strcmp(a, "--games") == 0) game_count = atoi(v);
+        else if (strcmp(a, "--maze") == 0) maze = v;
+        else if (strcmp(a, "--collide") == 0) {
+            kernel = 0;
+            while (kernel < COLLIDE_KERNELS && strcmp(v, collide_kernel_name((CollideKernel)kernel)) != 0) kernel++;
+            if (kernel == COLLIDE_KERNELS) { usage(argv[0]); return EXIT_FAILURE; }
+        }
+        else { usage(argv[0]); return EXIT_FAILURE; }
+        i++;
+    }
+    if (ticks <= 0 || game_count <= 0) { usage(argv[0]); return EXIT_FAILURE; }
+
+    Level lv;
+    if (!(maze ? level_maze_from_spec(&lv, maze) : level_classic(&lv))) {
+        fprintf(stderr, "level setup failed\n");
+        return EXIT_FAILURE;
+    }
+    Sim *sims = (Sim*)calloc((size_t)game_count, sizeof(Sim));
+    SimPilot *pilots = (SimPilot*)calloc((size_t)game_count, sizeof(SimPilot));
+    int ok = sims && pilots;
+    for (int i = 0; ok && i < game_count; ++i) {
+        ok = sim_init(&sims[i]) && sim_load_level(&sims[i], &lv) &&
+             sim_set_pellet_storage(&sims[i], pellet_storage);
+        if (ok) sim_set_ghost_count(&sims[i], ghosts);
+        if (ok && kernel >= 0 && !collide_boxes_use_kernel(&sims[i].wall_boxes, (CollideKernel)kernel)) {
+            fprintf(stderr, "collision kernel %s not available\n", collide_kernel_name((CollideKernel)kernel));
+            ok = 0;
+        }
+        sim_autopilot_init(&pilots[i], 0x2545F491u * (unsigned)(i + 1), FACE_RIGHT);
+    }
+    level_free(&lv);
+    if (!ok) {
+        fprintf(stderr, "sim setup failed\n");
+        for (int i = 0; sims && i < game_count; ++i) sim_shutdown(&sims[i]);
+        free(sims);
+        free(pilots);
+        return EXIT_FAILURE;
+    }
+
+    /* game by game, so each sim's state stays in cache for the whole run */
+    double start = seconds();
+    for (int i = 0; i < game_count; ++i)
+        for (long long t = 0; t < ticks; ++t) sim_autopilot_step(&pilots[i], &sims[i], SIM_DT);
+    double elapsed = seconds() - start;
+
+    long long eaten = 0;
+    unsigned long long h = 1469598103934665603ull;
+    for (int i = 0; i < game_count; ++i) {
+        eaten += sims[i].pellet_count - sims[i].pellets_left;
+        h = digest(&sims[i], h);
+    }
+    double total = (double)ticks * game_count;
+    printf("%d game(s) x %lld ticks (%d walls, %d pellets each) in %.3f s: %.0f ticks/s, %.1f ns/tick\n",
+           game_count, ticks, sims[0].wall_count, sims[0].pellet_count, elapsed,
+           total / elapsed, elapsed * 1e9 / total);
+    printf("%lld pellets eaten, %.1f simulated hours, %s collisions, state digest %016llx\n",
+           eaten, total * SIM_DT / 3600.0, collide_kernel_name(sims[0].wall_boxes.kernel), h);
+
+    for (int i = 0; i < game_count; ++i) sim_shutdown(&sims[i]);
+    free(sims);
+    free(pilots);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// src/snapshot.c
+// World instances and frame snapshots, built from a Sim alone. Nothing here
+// touches GL or the renderers, so drivers that only simulate and draw the
+// instances themselves (the spectator wall) link this without game.c.
+#include "game.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* world instance builders (render scales applied, see Instance in game.h) */
+static void set_instance(Instance *in, float x, float y, float sx, float sy,
+                         float r, float gr, float b, int shape) {
+    in->x = x; in->y = y; in->sx = sx; in->sy = sy;
+    in->r = r; in->g = gr; in->b = b; in->shape = (float)shape;
+}
+void game_wall_instance(const Rect *w, Instance *out) {
+    set_instance(out, w->x, w->y, w->halfW * WALL_SCALE_X, w->halfH * WALL_SCALE_Y,
+                 0.0f, 0.0f, 1.0f, SHAPE_RECT);
+}
+void game_pellet_instance(const Pellet *p, Instance *out) {
+    set_instance(out, p->x, p->y, p->r * PELLET_SCALE_X, p->r * PELLET_SCALE_Y,
+                 1.0f, 1.0f, 0.0f, SHAPE_CIRCLE);
+}
+static void player_instance(const FrameSnapshot *s, Instance *out) {
+    set_instance(out, s->posX, s->posY, s->half * PLAYER_SCALE_X, s->half * PLAYER_SCALE_Y,
+                 1.0f, 1.0f, 1.0f, SHAPE_PACMAN);
+}
+/* ghosts share the player's size */
+static void ghost_instance(const GameGhost *gh, float half, Instance *out) {
+    set_instance(out, gh->x, gh->y, half * PLAYER_SCALE_X, half * PLAYER_SCALE_Y,
+                 gh->r, gh->g, gh->b, SHAPE_GHOST);
+}
+/* the dynamic tail of the world buffer: player, then ghosts; the slots of
+   ghosts that are off stay zero-sized */
+void game_actor_instances(const FrameSnapshot *s, Instance *out) {
+    player_instance(s, &out[0]);
+    for (int i = 0; i < GAME_GHOSTS; ++i) {
+        if (i < s->ghost_count) ghost_instance(&s->ghosts[i], s->half, &out[1 + i]);
+        else set_instance(&out[1 + i], 0, 0, 0, 0, 0, 0, 0, SHAPE_GHOST);
+    }
+}
+
+void game_level_instances(const Sim *sim, Instance *out)
+{
+    for (int i = 0; i < sim->wall_count; ++i) game_wall_instance(&sim->walls[i], &out[i]);
+    out += sim->wall_count;
+    for (int i = 0; i < sim->pellet_count; ++i) {
+        if (sim_pellet_alive(sim, i)) game_pellet_instance(&sim->pellets[i], &out[i]);
+        else set_instance(&out[i], 0, 0, 0, 0, 0, 0, 0, SHAPE_CIRCLE);
+    }
+}
+
+int game_snapshot_alloc(FrameSnapshot *s, const Sim *sim)
+{
+    memset(s, 0, sizeof(*s));
+    if (sim->pellet_storage == PELLETS_BITMASK) {
+        s->alive_bytes = sim_pellet_alive_bytes(sim);
+        s->pellet_alive = (unsigned char*)calloc((size_t)(s->alive_bytes > 0 ? s->alive_bytes : 1), 1);
+        if (!s->pellet_alive) return 0;
+    }
+    return 1;
+}
+
+/* exact at both ends, so alpha 1 is the last tick as it is */
+static float blend(float prev, float cur, float alpha)
+{
+    return prev * (1.0f - alpha) + cur * alpha;
+}
+
+void game_snapshot(const Sim *sim, float alpha, FrameSnapshot *s)
+{
+    s->tick = sim->tick;
+    s->posX = blend(sim->prevX, sim->posX, alpha);
+    s->posY = blend(sim->prevY, sim->posY, alpha);
+    s->prevX = sim->prevX;
+    s->prevY = sim->prevY;
+    s->half = sim->half;
+    s->facing = sim->facing;
+    s->time = sim->time;
+    memcpy(s->ghosts, sim->ghosts, sizeof(s->ghosts));
+    s->ghost_count = sim->ghost_count;
+    for (int i = 0; i < GAME_GHOSTS; ++i) {
+        s->ghosts[i].x = blend(sim->ghosts[i].px, sim->ghosts[i].x, alpha);
+        s->ghosts[i].y = blend(sim->ghosts[i].py, sim->ghosts[i].y, alpha);
+    }
+    s->camX = blend(sim->prevCamX, sim->camX, alpha);
+    s->camY = blend(sim->prevCamY, sim->camY, alpha);
+    s->prevCamX = sim->prevCamX;
+    s->prevCamY = sim->prevCamY;
+    s->viewHalfX = sim->viewHalfX;
+    s->viewHalfY = sim->viewHalfY;
+    s->pellets_left = sim->pellets_left;
+    if (s->pellet_alive && sim->pellet_alive) {
+        int n = sim_pellet_alive_bytes(sim);
+        memcpy(s->pellet_alive, sim->pellet_alive, (size_t)(n < s->alive_bytes ? n : s->alive_bytes));
+    }
+}
+
+void game_snapshot_blend(const FrameSnapshot *s, float alpha, FrameSnapshot *out)
+{
+    *out = *s;
+    out->posX = blend(s->prevX, s->posX, alpha);
+    out->posY = blend(s->prevY, s->posY, alpha);
+    for (int i = 0; i < GAME_GHOSTS; ++i) {
+        out->ghosts[i].x = blend(s->ghosts[i].px, s->ghosts[i].x, alpha);
+        out->ghosts[i].y = blend(s->ghosts[i].py, s->ghosts[i].y, alpha);
+    }
+    out->camX = blend(s->prevCamX, s->camX, alpha);
+    out->camY = blend(s->prevCamY, s->camY, alpha);
+}
+
+void game_snapshot_free(FrameSnapshot *s)
+{
+    free(s->pellet_alive);
+    s->pellet_alive = NULL;
+    s->alive_bytes = 0;
+}
@@ -0,0 +1,464 @@
+// src/softrast.c
+#include "softrast.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/* As in collide.c: GCC and clang build the SSE2 and AVX2 span fillers
+   whatever -m flags the file gets, and softrast_init asks the CPU which to
+   use. MSVC x64 always has SSE2; anything else fills pixel by pixel. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SOFT_HAVE_SSE2 1
+#define SOFT_HAVE_AVX2 1
+#define SOFT_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_M_X64)
+#include <emmintrin.h>
+#define SOFT_HAVE_SSE2 1
+#define SOFT_TARGET(isa)
+#endif
+
+/* Every float expression below mirrors one in the GL pipeline, which rounds
+   after each operation; a fused multiply-add would change the last bit and
+   with it the odd edge pixel. */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+/* vertex positions are snapped to 1/256 pixel before edge tests */
+#define SOFT_SUBPIXEL 256
+
+/* world shader shape ids (game.h SHAPE_*) */
+#define SOFT_RECT   0
+#define SOFT_CIRCLE 1
+#define SOFT_PACMAN 2
+#define SOFT_GHOST  3
+
+/* fixed-point window coordinate; anything further out than this is off
+   screen either way */
+static int snap(float window)
+{
+    if (window < -32768.0f) window = -32768.0f;
+    if (window > 32768.0f) window = 32768.0f;
+    return (int)lrintf(window * (float)SOFT_SUBPIXEL);
+}
+
+/* first pixel whose centre is on or right of (above) a snapped edge: the left
+   and bottom edges of a quad own the centres exactly on them, the right and
+   top edges do not */
+static int first_center_at(int fixed)
+{
+    int v = fixed - SOFT_SUBPIXEL / 2;
+    int q = v / SOFT_SUBPIXEL;
+    if (q * SOFT_SUBPIXEL < v) q++;   /* ceil */
+    return q;
+}
+
+static int online_cpus(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+static int clampi(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+/* the vertex stage plus viewport transform and coverage of one quad;
+   returns 0 when it covers no pixel */
+static int setup_quad(const SoftRaster *r, const SoftQuad *q, SoftPrim *p)
+{
+    float vw = (float)r->width, vh = (float)r->height;
+    float sx = vw * 0.5f, sy = vh * 0.5f;
+    /* corners: aPos is +-0.5, so aPos * e is exact and each corner rounds once */
+    float nx0 = -0.5f * q->ex + q->cx, nx1 = 0.5f * q->ex + q->cx;
+    float ny0 = -0.5f * q->ey + q->cy, ny1 = 0.5f * q->ey + q->cy;
+
+    p->x0 = clampi(first_center_at(snap(nx0 * sx + sx)), 0, r->width);
+    p->x1 = clampi(first_center_at(snap(nx1 * sx + sx)), 0, r->width);
+    p->y0 = clampi(first_center_at(snap(ny0 * sy + sy)), 0, r->height);
+    p->y1 = clampi(first_center_at(snap(ny1 * sy + sy)), 0, r->height);
+    if (p->x0 >= p->x1 || p->y0 >= p->y1) return 0;
+
+    p->center_x = (q->cx * 0.5f + 0.5f) * vw;
+    p->center_y = (q->cy * 0.5f + 0.5f) * vh;
+    p->half_x = q->ex * 0.25f * vw;
+    p->half_y = q->ey * 0.25f * vh;
+    p->color = q->color;
+    p->shape = q->shape;
+    return 1;
+}
+
+/* the fragment shader's discard test for one pixel centre */
+static int keep_fragment(int shape, float qx, float qy)
+{
+    float d = qx * qx + qy * qy;
+    if (shape == SOFT_CIRCLE) return !(d > 1.0f);
+    if (shape == SOFT_PACMAN) return !(d > 1.0f || (qx > 0.0f && fabsf(qy) < qx * 0.6f));
+    if (shape == SOFT_GHOST) {
+        if (qy > 0.0f) return !(d > 1.0f);
+        float f = (qx + 1.0f) * 1.5f;
+        return !(qy < -0.75f && f - floorf(f) > 0.5f);
+    }
+    return 1;
+}
+
+/* one row of pixels [x0, x1): fill sets them all, shade runs the circle and
+   pac-man fragment test on each (qy is the row's q.y) */
+typedef void (*FillFn)(uint32_t *row, int x0, int x1, uint32_t color);
+typedef void (*ShadeFn)(uint32_t *row, int x0, int x1, float qy, const SoftPrim *p);
+
+typedef struct {
+    int lanes;
+    FillFn fill;
+    ShadeFn shade;
+} SpanKernel;
+
+static void fill_scalar(uint32_t *row, int x0, int x1, uint32_t color)
+{
+    for (int x = x0; x < x1; ++x) row[x] = color;
+}
+
+static void shade_scalar(uint32_t *row, int x0, int x1, float qy, const SoftPrim *p)
+{
+    for (int x = x0; x < x1; ++x) {
+        float qx = ((float)x + 0.5f - p->center_x) / p->half_x;
+        if (keep_fragment(p->shape, qx, qy)) row[x] = p->color;
+    }
+}
+
+#ifdef SOFT_HAVE_SSE2
+SOFT_TARGET("sse2")
+static void fill_sse2(uint32_t *row, int x0, int x1, uint32_t color)
+{
+    int x = x0;
+    __m128i c = _mm_set1_epi32((int)color);
+    for (; x + 4 <= x1; x += 4) _mm_storeu_si128((__m128i*)(row + x), c);
+    fill_scalar(row, x, x1, color);
+}
+
+SOFT_TARGET("sse2")
+static void shade_sse2(uint32_t *row, int x0, int x1, float qy, const SoftPrim *p)
+{
+    int x = x0;
+    const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+    const __m128 wedge = _mm_set1_ps(0.6f);
+    const __m128 step = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 cx = _mm_set1_ps(p->center_x), hx = _mm_set1_ps(p->half_x);
+    const __m128 qyy = _mm_set1_ps(qy * qy), aqy = _mm_set1_ps(fabsf(qy));
+    const __m128i color = _mm_set1_epi32((int)p->color);
+    for (; x + 4 <= x1; x += 4) {
+        __m128 fx = _mm_add_ps(_mm_set1_ps((float)x), step);
+        __m128 qx = _mm_div_ps(_mm_sub_ps(fx, cx), hx);
+        __m128 d = _mm_add_ps(_mm_mul_ps(qx, qx), qyy);
+        __m128 keep = _mm_cmpngt_ps(d, one);
+        if (p->shape == SOFT_PACMAN) {
+            __m128 mouth = _mm_and_ps(_mm_cmpgt_ps(qx, zero),
+                                      _mm_cmplt_ps(aqy, _mm_mul_ps(qx, wedge)));
+            keep = _mm_andnot_ps(mouth, keep);
+        }
+        __m128i m = _mm_castps_si128(keep);
+        __m128i old = _mm_loadu_si128((const __m128i*)(row + x));
+        _mm_storeu_si128((__m128i*)(row + x),
+                         _mm_or_si128(_mm_and_si128(m, color), _mm_andnot_si128(m, old)));
+    }
+    shade_scalar(row, x, x1, qy, p);
+}
+#endif
+
+#ifdef SOFT_HAVE_AVX2
+SOFT_TARGET("avx2")
+static void fill_avx2(uint32_t *row, int x0, int x1, uint32_t color)
+{
+    int x = x0;
+    __m256i c = _mm256_set1_epi32((int)color);
+    for (; x + 8 <= x1; x += 8) _mm256_storeu_si256((__m256i*)(row + x), c);
+    fill_scalar(row, x, x1, color);
+}
+
+SOFT_TARGET("avx2")
+static void shade_avx2(uint32_t *row, int x0, int x1, float qy, const SoftPrim *p)
+{
+    int x = x0;
+    const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+    const __m256 wedge = _mm256_set1_ps(0.6f);
+    const __m256 step = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    const __m256 cx = _mm256_set1_ps(p->center_x), hx = _mm256_set1_ps(p->half_x);
+    const __m256 qyy = _mm256_set1_ps(qy * qy), aqy = _mm256_set1_ps(fabsf(qy));
+    const __m256i color = _mm256_set1_epi32((int)p->color);
+    for (; x + 8 <= x1; x += 8) {
+        __m256 fx = _mm256_add_ps(_mm256_set1_ps((float)x), step);
+        __m256 qx = _mm256_div_ps(_mm256_sub_ps(fx, cx), hx);
+        __m256 d = _mm256_add_ps(_mm256_mul_ps(qx, qx), qyy);
+        __m256 keep = _mm256_cmp_ps(d, one, _CMP_NGT_UQ);
+        if (p->shape == SOFT_PACMAN) {
+            __m256 mouth = _mm256_and_ps(_mm256_cmp_ps(qx, zero, _CMP_GT_OQ),
+                                         _mm256_cmp_ps(aqy, _mm256_mul_ps(qx, wedge), _CMP_LT_OQ));
+            keep = _mm256_andnot_ps(mouth, keep);
+        }
+        __m256i m = _mm256_castps_si256(keep);
+        __m256i old = _mm256_loadu_si256((const __m256i*)(row + x));
+        _mm256_storeu_si256((__m256i*)(row + x),
+                            _mm256_or_si256(_mm256_and_si256(m, color), _mm256_andnot_si256(m, old)));
+    }
+    shade_scalar(row, x, x1, qy, p);
+}
+#endif
+
+/* widest first */
+static const SpanKernel span_kernels[] = {
+#ifdef SOFT_HAVE_AVX2
+    { 8, fill_avx2, shade_avx2 },
+#endif
+#ifdef SOFT_HAVE_SSE2
+    { 4, fill_sse2, shade_sse2 },
+#endif
+    { 1, fill_scalar, shade_scalar },
+};
+
+static int cpu_runs(const SpanKernel *k)
+{
+#ifdef SOFT_HAVE_AVX2
+    /* GCC / clang on x86: the kernels exist, the CPU may still lack them */
+    if (k->lanes == 8) return __builtin_cpu_supports("avx2");
+    if (k->lanes == 4) return __builtin_cpu_supports("sse2");
+#endif
+    (void)k;
+    return 1;
+}
+
+static void raster_tile(SoftRaster *r, int tile)
+{
+    int tx0 = (tile % r->tiles_x) * SOFT_TILE, ty0 = (tile / r->tiles_x) * SOFT_TILE;
+    int tx1 = tx0 + SOFT_TILE < r->width ? tx0 + SOFT_TILE : r->width;
+    int ty1 = ty0 + SOFT_TILE < r->height ? ty0 + SOFT_TILE : r->height;
+
+    const SpanKernel *spans = &span_kernels[r->span_kernel];
+    for (int y = ty0; y < ty1; ++y) spans->fill(r->pixels + (size_t)y * r->width, tx0, tx1, r->clear_color);
+
+    for (int k = r->bin_start[tile]; k < r->bin_start[tile + 1]; ++k) {
+        const SoftPrim *p = &r->prims[r->bin_items[k]];
+        int x0 = p->x0 > tx0 ? p->x0 : tx0, x1 = p->x1 < tx1 ? p->x1 : tx1;
+        int y0 = p->y0 > ty0 ? p->y0 : ty0, y1 = p->y1 < ty1 ? p->y1 : ty1;
+        for (int y = y0; y < y1; ++y) {
+            uint32_t *row = r->pixels + (size_t)y * r->width;
+            if (p->shape == SOFT_RECT) {
+                spans->fill(row, x0, x1, p->color);
+                continue;
+            }
+            float qy = ((float)y + 0.5f - p->center_y) / p->half_y;
+            if (p->shape == SOFT_GHOST) shade_scalar(row, x0, x1, qy, p);
+            else spans->shade(row, x0, x1, qy, p);
+        }
+    }
+}
+
+static void run_tiles(SoftRaster *r)
+{
+    int tiles = r->tiles_x * r->tiles_y;
+    for (;;) {
+        int t = atomic_fetch_add(&r->next_tile, 1);
+        if (t >= tiles) break;
+        raster_tile(r, t);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    SoftRaster *r = (SoftRaster*)arg;
+    /* generation is 0 until the first frame; a worker that only gets here
+       after that frame was posted must still take part in it */
+    unsigned long long seen = 0;
+    pthread_mutex_lock(&r->lock);
+    for (;;) {
+        while (!r->quit && r->generation == seen) pthread_cond_wait(&r->wake, &r->lock);
+        if (r->quit) break;
+        seen = r->generation;
+        pthread_mutex_unlock(&r->lock);
+
+        run_tiles(r);
+
+        pthread_mutex_lock(&r->lock);
+        if (--r->busy == 0) pthread_cond_signal(&r->done);
+    }
+    pthread_mutex_unlock(&r->lock);
+    return NULL;
+}
+
+int softrast_init(SoftRaster *r, int threads)
+{
+    if (!r) return 0;
+    memset(r, 0, sizeof(*r));
+    if (threads <= 0) threads = online_cpus();
+    r->threads = threads;
+    while (!cpu_runs(&span_kernels[r->span_kernel])) r->span_kernel++;
+    atomic_init(&r->next_tile, 0);
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->wake, NULL);
+    pthread_cond_init(&r->done, NULL);
+
+    if (threads > 1) {
+        r->workers = (pthread_t*)malloc(sizeof(pthread_t) * (threads - 1));
+        if (!r->workers) return 0;
+        for (int i = 0; i < threads - 1; ++i) {
+            if (pthread_create(&r->workers[i], NULL, worker_main, r) != 0) {
+                fprintf(stderr, "softrast_init: pthread_create failed, using %d threads\n", i + 1);
+                break;
+            }
+            r->worker_count++;
+        }
+        r->threads = r->worker_count + 1;
+    }
+    return 1;
+}
+
+int softrast_lanes(const SoftRaster *r)
+{
+    return span_kernels[r->span_kernel].lanes;
+}
+
+void softrast_shutdown(SoftRaster *r)
+{
+    if (!r) return;
+    pthread_mutex_lock(&r->lock);
+    r->quit = 1;
+    pthread_cond_broadcast(&r->wake);
+    pthread_mutex_unlock(&r->lock);
+    for (int i = 0; i < r->worker_count; ++i) pthread_join(r->workers[i], NULL);
+    free(r->workers); r->workers = NULL;
+    r->worker_count = 0;
+    pthread_cond_destroy(&r->done);
+    pthread_cond_destroy(&r->wake);
+    pthread_mutex_destroy(&r->lock);
+
+    free(r->pixels); r->pixels = NULL;
+    free(r->prims); r->prims = NULL;
+    free(r->bin_start); r->bin_start = NULL;
+    free(r->bin_items); r->bin_items = NULL;
+    r->prim_capacity = r->bin_capacity = 0;
+    r->width = r->height = 0;
+}
+
+int softrast_resize(SoftRaster *r, int width, int height)
+{
+    if (width <= 0 || height <= 0) return 0;
+    if (r->pixels && width == r->width && height == r->height) return 1;
+
+    int tiles_x = (width + SOFT_TILE - 1) / SOFT_TILE;
+    int tiles_y = (height + SOFT_TILE - 1) / SOFT_TILE;
+    uint32_t *pixels = (uint32_t*)malloc(sizeof(uint32_t) * (size_t)width * height);
+    int *bin_start = (int*)malloc(sizeof(int) * (tiles_x * tiles_y + 1));
+    if (!pixels || !bin_start) {
+        free(pixels); free(bin_start);
+        return 0;
+    }
+    free(r->pixels);
+    free(r->bin_start);
+    r->pixels = pixels;
+    r->bin_start = bin_start;
+    r->width = width; r->height = height;
+    r->tiles_x = tiles_x; r->tiles_y = tiles_y;
+    return 1;
+}
+
+/* set up every quad and sort the survivors into per-tile lists (CSR, in
+   submission order) */
+static int bin_quads(SoftRaster *r, const SoftQuad *quads, int count)
+{
+    if (count > r->prim_capacity) {
+        SoftPrim *prims = (SoftPrim*)realloc(r->prims, sizeof(SoftPrim) * count);
+        if (!prims) return 0;
+        r->prims = prims;
+        r->prim_capacity = count;
+    }
+    int tiles = r->tiles_x * r->tiles_y;
+    memset(r->bin_start, 0, sizeof(int) * (tiles + 1));
+
+    int n = 0, entries = 0;
+    for (int i = 0; i < count; ++i) {
+        SoftPrim *p = &r->prims[n];
+        if (!setup_quad(r, &quads[i], p)) continue;
+        for (int ty = p->y0 / SOFT_TILE; ty <= (p->y1 - 1) / SOFT_TILE; ++ty)
+            for (int tx = p->x0 / SOFT_TILE; tx <= (p->x1 - 1) / SOFT_TILE; ++tx) {
+                r->bin_start[ty * r->tiles_x + tx + 1]++;
+                entries++;
+            }
+        n++;
+    }
+    r->prim_count = n;
+
+    if (entries > r->bin_capacity) {
+        int *items = (int*)realloc(r->bin_items, sizeof(int) * entries);
+        if (!items) return 0;
+        r->bin_items = items;
+        r->bin_capacity = entries;
+    }
+    for (int t = 0; t < tiles; ++t) r->bin_start[t + 1] += r->bin_start[t];
+
+    /* bin_start[t] walks up to bin_start[t + 1] while filling, then is
+       restored from its neighbour */
+    for (int i = 0; i < n; ++i) {
+        const SoftPrim *p = &r->prims[i];
+        for (int ty = p->y0 / SOFT_TILE; ty <= (p->y1 - 1) / SOFT_TILE; ++ty)
+            for (int tx = p->x0 / SOFT_TILE; tx <= (p->x1 - 1) / SOFT_TILE; ++tx)
+                r->bin_items[r->bin_start[ty * r->tiles_x + tx]++] = i;
+    }
+    for (int t = tiles; t > 0; --t) r->bin_start[t] = r->bin_start[t - 1];
+    r->bin_start[0] = 0;
+    return 1;
+}
+
+void softrast_draw(SoftRaster *r, const SoftQuad *quads, int count, uint32_t clear_color)
+{
+    if (!r->pixels) return;
+    r->clear_color = clear_color;
+    if (!bin_quads(r, quads, count)) {
+        fprintf(stderr, "softrast_draw: out of memory, drawing nothing\n");
+        r->prim_count = 0;
+        memset(r->bin_start, 0, sizeof(int) * (r->tiles_x * r->tiles_y + 1));
+    }
+
+    atomic_store(&r->next_tile, 0);
+    if (r->worker_count > 0) {
+        pthread_mutex_lock(&r->lock);
+        r->generation++;
+        r->busy = r->worker_count;
+        pthread_cond_broadcast(&r->wake);
+        pthread_mutex_unlock(&r->lock);
+    }
+
+    run_tiles(r);
+
+    if (r->worker_count > 0) {
+        pthread_mutex_lock(&r->lock);
+        while (r->busy > 0) pthread_cond_wait(&r->done, &r->lock);
+        pthread_mutex_unlock(&r->lock);
+    }
+}
+
+void softrast_read_rgba(const SoftRaster *r, unsigned char *out)
+{
+    for (int y = 0; y < r->height; ++y) {
+        const uint32_t *src = r->pixels + (size_t)(r->height - 1 - y) * r->width;
+        unsigned char *dst = out + (size_t)y * r->width * 4;
+        for (int x = 0; x < r->width; ++x) {
+            uint32_t c = src[x];
+            dst[4 * x + 0] = (unsigned char)(c & 0xFF);
+            dst[4 * x + 1] = (unsigned char)((c >> 8) & 0xFF);
+            dst[4 * x + 2] = (unsigned char)((c >> 16) & 0xFF);
+            dst[4 * x + 3] = (unsigned char)(c >> 24);
+        }
+    }
+}
@@ -0,0 +1,319 @@
+// src/spectator.c
+#include "spectator.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* one instance of the wall draw: the world instance plus attr 3, its game and
+   its bit in the alive texture (-1 for actors and walls) */
+typedef struct {
+    Instance in;
+    float game, pellet;
+} SpectatorInstance;
+
+/* texels of the view buffer per game: camera, tile */
+#define SPECTATOR_VIEW_TEXELS 2
+
+/* actors are staged on the stack this many games at a time */
+#define SPECTATOR_ACTOR_CHUNK 16
+
+static void destroy_level(Spectator *sp)
+{
+    if (sp->vbo) glDeleteBuffers(1, &sp->vbo);
+    sp->vbo = 0;
+    sp->instance_count = 0;
+    free(sp->alive_offset); sp->alive_offset = NULL;
+    free(sp->gpu_alive); sp->gpu_alive = NULL;
+}
+
+int spectator_rebuild(Spectator *sp)
+{
+    destroy_level(sp);
+
+    int walls = 0, pellets = 0;
+    sp->alive_offset = (int*)malloc(sizeof(int) * (sp->game_count + 1));
+    if (!sp->alive_offset) return 0;
+    sp->alive_offset[0] = 0;
+    for (int i = 0; i < sp->game_count; ++i) {
+        Sim *g = &sp->sims[i];
+        if (!sim_set_pellet_storage(g, PELLETS_BITMASK)) return 0;
+        walls += g->wall_count;
+        pellets += g->pellet_count;
+        sp->alive_offset[i + 1] = sp->alive_offset[i] + sim_pellet_alive_bytes(g);
+    }
+
+    int actors = sp->game_count * WORLD_DYNAMIC_SLOTS;
+    int total = walls + pellets + actors;
+    int bytes = sp->alive_offset[sp->game_count];
+    SpectatorInstance *inst = (SpectatorInstance*)malloc(sizeof(SpectatorInstance) * total);
+    Instance *level = NULL;
+    sp->gpu_alive = (unsigned char*)calloc((size_t)(bytes > 0 ? bytes : 1), 1);
+    if (!inst || !sp->gpu_alive) {
+        free(inst);
+        return 0;
+    }
+
+    /* every game's walls, then every game's pellets, then every game's
+       actors (rewritten every frame), so actors draw over the levels */
+    int wall_at = 0, pellet_at = walls;
+    sp->actor_base = walls + pellets;
+    for (int i = 0; i < sp->game_count; ++i) {
+        const Sim *g = &sp->sims[i];
+        int n = g->wall_count + g->pellet_count;
+        Instance *tmp = (Instance*)realloc(level, sizeof(Instance) * (n > 0 ? n : 1));
+        if (!tmp) {
+            free(level); free(inst);
+            return 0;
+        }
+        level = tmp;
+        game_level_instances(g, level);
+
+        for (int a = 0; a < WORLD_DYNAMIC_SLOTS; ++a) {
+            SpectatorInstance *in = &inst[sp->actor_base + i * WORLD_DYNAMIC_SLOTS + a];
+            memset(&in->in, 0, sizeof(in->in));
+            in->game = (float)i;
+            in->pellet = -1.0f;
+        }
+        for (int w = 0; w < g->wall_count; ++w, ++wall_at) {
+            inst[wall_at].in = level[w];
+            inst[wall_at].game = (float)i;
+            inst[wall_at].pellet = -1.0f;
+        }
+        for (int p = 0; p < g->pellet_count; ++p, ++pellet_at) {
+            inst[pellet_at].in = level[g->wall_count + p];
+            inst[pellet_at].game = (float)i;
+            inst[pellet_at].pellet = (float)(sp->alive_offset[i] * 8 + p);
+        }
+        memcpy(sp->gpu_alive + sp->alive_offset[i], g->pellet_alive, (size_t)(sp->alive_offset[i + 1] - sp->alive_offset[i]));
+    }
+    free(level);
+
+    glGenBuffers(1, &sp->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, sp->vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SpectatorInstance) * total, inst, GL_DYNAMIC_DRAW);
+    free(inst);
+    sp->instance_count = total;
+
+    glBindVertexArray(sp->vao);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpectatorInstance), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpectatorInstance), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(SpectatorInstance), (void*)offsetof(SpectatorInstance, game));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glBindVertexArray(0);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, sp->alive_buf);
+    glBufferData(GL_TEXTURE_BUFFER, bytes > 0 ? bytes : 1, sp->gpu_alive, GL_DYNAMIC_DRAW);
+    return 1;
+}
+
+int spectator_init(Spectator *sp, GLuint program, GLuint quad_vbo, GLuint quad_ebo,
+                   Sim *sims, int game_count, int tile_w, int tile_h)
+{
+    memset(sp, 0, sizeof(*sp));
+    if (!sims || game_count <= 0 || tile_w <= 0 || tile_h <= 0) return 0;
+    sp->sims = sims;
+    sp->game_count = game_count;
+    sp->cols = (int)ceil(sqrt((double)game_count));
+    sp->rows = (game_count + sp->cols - 1) / sp->cols;
+    sp->tile_w = tile_w;
+    sp->tile_h = tile_h;
+    sp->width = sp->cols * tile_w;
+    sp->height = sp->rows * tile_h;
+
+    sp->program = program;
+    sp->loc_uAtlas = glGetUniformLocation(program, "uAtlas");
+    sp->loc_uViews = glGetUniformLocation(program, "uViews");
+    sp->loc_uPelletAlive = glGetUniformLocation(program, "uPelletAlive");
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &max_size);
+    if (sp->width > max_size || sp->height > max_size) {
+        fprintf(stderr, "spectator: %dx%d atlas exceeds GL_MAX_RENDERBUFFER_SIZE %d\n",
+                sp->width, sp->height, max_size);
+        return 0;
+    }
+    glGenRenderbuffers(1, &sp->color_rb);
+    glBindRenderbuffer(GL_RENDERBUFFER, sp->color_rb);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, sp->width, sp->height);
+    glGenFramebuffers(1, &sp->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, sp->fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, sp->color_rb);
+    int complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        fprintf(stderr, "spectator: atlas framebuffer incomplete\n");
+        return 0;
+    }
+
+    /* the unit quad; the instance attributes are pointed at by rebuild */
+    glGenVertexArrays(1, &sp->vao);
+    glBindVertexArray(sp->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ebo);
+    glBindVertexArray(0);
+
+    /* cameras change every frame; tiles stay, row 0 at the top of the atlas */
+    sp->views = (float*)calloc((size_t)game_count * SPECTATOR_VIEW_TEXELS * 4, sizeof(float));
+    if (!sp->views) return 0;
+    for (int i = 0; i < game_count; ++i) {
+        float *tile = sp->views + (i * SPECTATOR_VIEW_TEXELS + 1) * 4;
+        tile[0] = (float)((i % sp->cols) * tile_w);
+        tile[1] = (float)((sp->rows - 1 - i / sp->cols) * tile_h);
+        tile[2] = (float)tile_w;
+        tile[3] = (float)tile_h;
+    }
+    glGenBuffers(1, &sp->view_buf);
+    glGenTextures(1, &sp->view_tex);
+    glBindBuffer(GL_TEXTURE_BUFFER, sp->view_buf);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(float) * 4 * SPECTATOR_VIEW_TEXELS * game_count, NULL, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, sp->view_tex);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, sp->view_buf);
+
+    glGenBuffers(1, &sp->alive_buf);
+    glGenTextures(1, &sp->alive_tex);
+    glBindBuffer(GL_TEXTURE_BUFFER, sp->alive_buf);
+    glBufferData(GL_TEXTURE_BUFFER, 1, NULL, GL_DYNAMIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, sp->alive_tex);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R8UI, sp->alive_buf);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    return spectator_rebuild(sp);
+}
+
+void spectator_shutdown(Spectator *sp)
+{
+    destroy_level(sp);
+    if (sp->vao) glDeleteVertexArrays(1, &sp->vao);
+    if (sp->fbo) glDeleteFramebuffers(1, &sp->fbo);
+    if (sp->color_rb) glDeleteRenderbuffers(1, &sp->color_rb);
+    if (sp->view_tex) glDeleteTextures(1, &sp->view_tex);
+    if (sp->view_buf) glDeleteBuffers(1, &sp->view_buf);
+    if (sp->alive_tex) glDeleteTextures(1, &sp->alive_tex);
+    if (sp->alive_buf) glDeleteBuffers(1, &sp->alive_buf);
+    free(sp->views);
+    memset(sp, 0, sizeof(*sp));
+}
+
+/* runs of alive bytes that changed since the last frame, per game */
+static void sync_alive(Spectator *sp)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, sp->alive_buf);
+    for (int g = 0; g < sp->game_count; ++g) {
+        const unsigned char *bits = sp->sims[g].pellet_alive;
+        int base = sp->alive_offset[g], n = sp->alive_offset[g + 1] - base;
+        unsigned char *mirror = sp->gpu_alive + base;
+        int i = 0;
+        while (i < n) {
+            if (bits[i] == mirror[i]) { i++; continue; }
+            int start = i;
+            while (i < n && bits[i] != mirror[i]) i++;
+            memcpy(mirror + start, bits + start, (size_t)(i - start));
+            glBufferSubData(GL_TEXTURE_BUFFER, base + start, i - start, mirror + start);
+        }
+    }
+}
+
+void spectator_render(Spectator *sp, float alpha)
+{
+    /* per-frame state: actors, cameras, eaten pellets. The snapshots leave
+       pellet_alive NULL, so they copy no alive bits; sync_alive reads those
+       from the sims. */
+    SpectatorInstance actors[SPECTATOR_ACTOR_CHUNK * WORLD_DYNAMIC_SLOTS];
+    Instance inst[WORLD_DYNAMIC_SLOTS];
+    FrameSnapshot s;
+    memset(&s, 0, sizeof(s));
+    glBindBuffer(GL_ARRAY_BUFFER, sp->vbo);
+    for (int first = 0; first < sp->game_count; first += SPECTATOR_ACTOR_CHUNK) {
+        int n = sp->game_count - first;
+        if (n > SPECTATOR_ACTOR_CHUNK) n = SPECTATOR_ACTOR_CHUNK;
+        for (int i = 0; i < n; ++i) {
+            game_snapshot(&sp->sims[first + i], alpha, &s);
+            game_actor_instances(&s, inst);
+            for (int a = 0; a < WORLD_DYNAMIC_SLOTS; ++a) {
+                SpectatorInstance *in = &actors[i * WORLD_DYNAMIC_SLOTS + a];
+                in->in = inst[a];
+                in->game = (float)(first + i);
+                in->pellet = -1.0f;
+            }
+            float *cam = sp->views + (first + i) * SPECTATOR_VIEW_TEXELS * 4;
+            cam[0] = s.camX;
+            cam[1] = s.camY;
+            cam[2] = 1.0f / s.viewHalfX;
+            cam[3] = 1.0f / s.viewHalfY;
+        }
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        sizeof(SpectatorInstance) * (sp->actor_base + first * WORLD_DYNAMIC_SLOTS),
+                        sizeof(SpectatorInstance) * n * WORLD_DYNAMIC_SLOTS, actors);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, sp->view_buf);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(float) * 4 * SPECTATOR_VIEW_TEXELS * sp->game_count, sp->views, GL_STREAM_DRAW);
+    sync_alive(sp);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, sp->fbo);
+    glViewport(0, 0, sp->width, sp->height);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glUseProgram(sp->program);
+    glUniform2f(sp->loc_uAtlas, (float)sp->width, (float)sp->height);
+    glUniform1i(sp->loc_uViews, 0);
+    glUniform1i(sp->loc_uPelletAlive, 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, sp->view_tex);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, sp->alive_tex);
+    glActiveTexture(GL_TEXTURE0);
+
+    for (int i = 0; i < 4; ++i) glEnable(GL_CLIP_DISTANCE0 + i);
+    glBindVertexArray(sp->vao);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, sp->instance_count);
+    glBindVertexArray(0);
+    for (int i = 0; i < 4; ++i) glDisable(GL_CLIP_DISTANCE0 + i);
+    sp->draw_calls = 1;
+}
+
+void spectator_blit(const Spectator *sp, int fb_width, int fb_height)
+{
+    /* largest scale that fits, centred */
+    double s = fmin((double)fb_width / sp->width, (double)fb_height / sp->height);
+    int w = (int)(sp->width * s), h = (int)(sp->height * s);
+    int x = (fb_width - w) / 2, y = (fb_height - h) / 2;
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glViewport(0, 0, fb_width, fb_height);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, sp->fbo);
+    glBlitFramebuffer(0, 0, sp->width, sp->height, x, y, x + w, y + h, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+int spectator_read_rgba(const Spectator *sp, unsigned char *out)
+{
+    size_t row = (size_t)sp->width * 4;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, sp->fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, sp->width, sp->height, GL_RGBA, GL_UNSIGNED_BYTE, out);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    if (glGetError() != GL_NO_ERROR) return 0;
+
+    /* GL rows start at the bottom; flip in place */
+    unsigned char *tmp = (unsigned char*)malloc(row);
+    if (!tmp) return 0;
+    for (int y = 0; y < sp->height / 2; ++y) {
+        unsigned char *a = out + (size_t)y * row;
+        unsigned char *b = out + (size_t)(sp->height - 1 - y) * row;
+        memcpy(tmp, a, row);
+        memcpy(a, b, row);
+        memcpy(b, tmp, row);
+    }
+    free(tmp);
+    return 1;
+}
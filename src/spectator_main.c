@@ -0,0 +1,180 @@
+// src/spectator_main.c
+// Spectator wall: runs many games with wandering autopilots and shows them all
+// at once, every frame one instanced draw into a tiled atlas (spectator.h).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLFW_INCLUDE_NONE
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "game.h"
+#include "gfx.h"
+#include "level.h"
+#include "spectator.h"
+
+static int write_ppm(const char *path, const unsigned char *rgba, int w, int h)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return 0;
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for (int i = 0; i < w * h; ++i) fwrite(rgba + (size_t)i * 4, 1, 3, f);
+    return fclose(f) == 0;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--games N] [--tile WxH] [--maze WxH] [--frames N] [--dump FRAME] [--out PREFIX]\n"
+            "          [--shaders DIR] [--shader-cache DIR|none] [--ghosts]\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    int game_count = 64, tile_w = 240, tile_h = 135;
+    int maze_w = 0, maze_h = 0;
+    int frames = 0, dump_frame = -1;
+    const char *out_prefix = "spectator";
+    const char *shader_dir = "shaders";
+    const char *shader_cache = NULL;
+    int ghosts = 0;
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--ghosts") == 0) { ghosts = GAME_GHOSTS; continue; }
+        if (!v) { usage(argv[0]); return EXIT_FAILURE; }
+        if (strcmp(a, "--games") == 0) game_count = atoi(v);
+        else if (strcmp(a, "--tile") == 0) {
+            if (sscanf(v, "%dx%d", &tile_w, &tile_h) != 2) { usage(argv[0]); return EXIT_FAILURE; }
+        }
+        else if (strcmp(a, "--maze") == 0) {
+            if (sscanf(v, "%dx%d", &maze_w, &maze_h) != 2) { usage(argv[0]); return EXIT_FAILURE; }
+        }
+        else if (strcmp(a, "--frames") == 0) frames = atoi(v);
+        else if (strcmp(a, "--dump") == 0) dump_frame = atoi(v);
+        else if (strcmp(a, "--out") == 0) out_prefix = v;
+        else if (strcmp(a, "--shaders") == 0) shader_dir = v;
+        else if (strcmp(a, "--shader-cache") == 0) shader_cache = v;
+        else { usage(argv[0]); return EXIT_FAILURE; }
+        i++;
+    }
+    if (game_count <= 0 || tile_w <= 0 || tile_h <= 0) { usage(argv[0]); return EXIT_FAILURE; }
+
+    /* the games only simulate; the wall draws them all from their sims */
+    Sim *sims = (Sim*)calloc((size_t)game_count, sizeof(Sim));
+    SimPilot *pilots = (SimPilot*)calloc((size_t)game_count, sizeof(SimPilot));
+    if (!sims || !pilots) return EXIT_FAILURE;
+    for (int i = 0; i < game_count; ++i) {
+        Level lv;
+        int loaded = 0;
+        sim_init(&sims[i]);
+        if (maze_w > 0 && maze_h > 0) {
+            loaded = level_maze(&lv, maze_w, maze_h, (unsigned)i + 1) && sim_load_level(&sims[i], &lv);
+            level_free(&lv);
+            if (!loaded) fprintf(stderr, "game %d: maze not loaded, playing the classic level\n", i);
+        }
+        if (!loaded) {
+            loaded = level_classic(&lv) && sim_load_level(&sims[i], &lv);
+            level_free(&lv);
+        }
+        if (!loaded) {
+            fprintf(stderr, "game %d init failed\n", i);
+            return EXIT_FAILURE;
+        }
+        sim_set_ghost_count(&sims[i], ghosts);
+        sim_autopilot_init(&pilots[i], 0x9E3779B9u * (unsigned)(i + 1), i % 4);
+    }
+
+    if (!glfwInit()) {
+        fprintf(stderr, "GLFW init failed\n");
+        return EXIT_FAILURE;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    GLFWwindow *window = glfwCreateWindow(1280, 720, "pman spectator", NULL, NULL);
+    if (!window) {
+        fprintf(stderr, "GLFW window failed\n");
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        fprintf(stderr, "Failed to load GLAD\n");
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+    GfxQuad quad;
+    Spectator sp;
+    shader_cache = gfx_cache_dir(shader_cache);
+    GLuint program = gfx_create_program_pair(shader_dir, "spectator", "basic", shader_cache, NULL);
+    if (!program || !gfx_create_quad(&quad) ||
+        !spectator_init(&sp, program, quad.vbo, quad.ebo, sims, game_count, tile_w, tile_h)) {
+        fprintf(stderr, "spectator setup failed\n");
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    printf("spectator: %d games in a %dx%d atlas (%d x %d tiles), %d instances per frame\n",
+           game_count, sp.width, sp.height, sp.cols, sp.rows, sp.instance_count);
+
+    unsigned char *pixels = NULL;
+    if (dump_frame >= 0) pixels = (unsigned char*)malloc((size_t)sp.width * sp.height * 4);
+
+    double last = glfwGetTime(), title_time = last;
+    int title_frames = 0;
+    /* every game ticks at SIM_DT; the clock's catch-up cap keeps a stall
+       from turning into a burst of ticks */
+    SimClock sim_clock;
+    sim_clock_init(&sim_clock);
+    for (int f = 0; !glfwWindowShouldClose(window) && (frames <= 0 || f < frames); ++f) {
+        double now = glfwGetTime();
+        int steps = sim_clock_advance(&sim_clock, now - last);
+        last = now;
+        glfwPollEvents();
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) break;
+
+        for (int t = 0; t < steps; ++t)
+            for (int i = 0; i < game_count; ++i) sim_autopilot_step(&pilots[i], &sims[i], SIM_DT);
+
+        spectator_render(&sp, sim_clock_alpha(&sim_clock));
+        if (f == dump_frame) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s_%05d.ppm", out_prefix, f);
+            if (!pixels || !spectator_read_rgba(&sp, pixels) || !write_ppm(path, pixels, sp.width, sp.height))
+                fprintf(stderr, "failed to write %s\n", path);
+        }
+        int fbw, fbh;
+        glfwGetFramebufferSize(window, &fbw, &fbh);
+        spectator_blit(&sp, fbw, fbh);
+        glfwSwapBuffers(window);
+        title_frames++;
+
+        if (now - title_time >= 1.0) {
+            int left = 0;
+            for (int i = 0; i < game_count; ++i) left += sims[i].pellets_left;
+            char title[256];
+            snprintf(title, sizeof(title), "pman spectator | %d games | %.0f fps | %d draw call, %d instances | %d pellets left",
+                     game_count, title_frames / (now - title_time), sp.draw_calls, sp.instance_count, left);
+            glfwSetWindowTitle(window, title);
+            title_time = now;
+            title_frames = 0;
+        }
+    }
+
+    free(pixels);
+    spectator_shutdown(&sp);
+    gfx_destroy_quad(&quad);
+    glDeleteProgram(program);
+    for (int i = 0; i < game_count; ++i) sim_shutdown(&sims[i]);
+    free(sims);
+    free(pilots);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
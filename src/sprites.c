@@ -0,0 +1,185 @@
+// src/sprites.c
+#include "sprites.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* pac-man: closed, half open, open, half open; mouth half-angle tangents */
+#define PACMAN_FRAMES 4
+static const float pacman_mouth[PACMAN_FRAMES] = { 0.0f, 0.35f, 0.8f, 0.35f };
+/* ghost: two skirt phases */
+#define GHOST_FRAMES 2
+
+#define SPRITE_TINTED 255
+#define SPRITE_FIXED 128
+
+static void put(unsigned char *px, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    px[0] = r; px[1] = g; px[2] = b; px[3] = a;
+}
+
+/* texel (x, y) of a layer as [-1, 1] coordinates, y up (row 0 is the bottom,
+   where sprite.vs puts uv 0) */
+static void texel_pos(int x, int y, float *u, float *v)
+{
+    *u = (x + 0.5f) * (2.0f / SPRITE_SIZE) - 1.0f;
+    *v = (y + 0.5f) * (2.0f / SPRITE_SIZE) - 1.0f;
+}
+
+/* (u, v) turned so the facing points along +u */
+static void face(int facing, float u, float v, float *fu, float *fv)
+{
+    switch (facing) {
+    case 1:  *fu = -u; *fv = v;  break;   // left
+    case 2:  *fu = v;  *fv = u;  break;   // up
+    case 3:  *fu = -v; *fv = u;  break;   // down
+    default: *fu = u;  *fv = v;  break;   // right
+    }
+}
+
+static void draw_pacman(unsigned char *layer, int facing, float mouth)
+{
+    for (int y = 0; y < SPRITE_SIZE; ++y) {
+        for (int x = 0; x < SPRITE_SIZE; ++x) {
+            float u, v, fu, fv;
+            texel_pos(x, y, &u, &v);
+            face(facing, u, v, &fu, &fv);
+            unsigned char *px = layer + (y * SPRITE_SIZE + x) * 4;
+            int body = u * u + v * v <= 0.95f * 0.95f;
+            int gap = fu > 0.0f && fabsf(fv) < fu * mouth;
+            if (body && !gap) put(px, 255, 255, 255, SPRITE_TINTED);
+        }
+    }
+}
+
+static void draw_ghost(unsigned char *layer, int facing, int frame)
+{
+    /* pupils look along the facing */
+    static const float look[SPRITE_FACINGS][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    for (int y = 0; y < SPRITE_SIZE; ++y) {
+        for (int x = 0; x < SPRITE_SIZE; ++x) {
+            float u, v;
+            texel_pos(x, y, &u, &v);
+            unsigned char *px = layer + (y * SPRITE_SIZE + x) * 4;
+            float dome = u * u + (v - 0.05f) * (v - 0.05f);
+            int body = v > 0.05f ? dome <= 0.9f * 0.9f : fabsf(u) <= 0.9f && v >= -0.9f;
+            if (v < -0.65f && fmodf((u + 1.0f) * 2.0f + 0.5f * frame, 1.0f) > 0.5f) body = 0;
+            if (!body) continue;
+            put(px, 255, 255, 255, SPRITE_TINTED);
+            for (int e = -1; e <= 1; e += 2) {
+                float ex = u - 0.35f * e, ey = v - 0.2f;
+                if (ex * ex / (0.22f * 0.22f) + ey * ey / (0.28f * 0.28f) > 1.0f) continue;
+                float px_ = ex - look[facing][0] * 0.1f, py_ = ey - look[facing][1] * 0.12f;
+                if (px_ * px_ + py_ * py_ <= 0.11f * 0.11f) put(px, 30, 30, 200, SPRITE_FIXED);
+                else put(px, 255, 255, 255, SPRITE_FIXED);
+            }
+        }
+    }
+}
+
+static int anim_layer(const SpriteAnim *a, int facing, int frame)
+{
+    return a->first_layer + (facing & (SPRITE_FACINGS - 1)) * a->frames + frame;
+}
+
+/* every animation frame for every facing, one layer each */
+static int build_sheet(Sprites *sp)
+{
+    sp->anims[SPRITE_ANIM_PACMAN].first_layer = 0;
+    sp->anims[SPRITE_ANIM_PACMAN].frames = PACMAN_FRAMES;
+    sp->anims[SPRITE_ANIM_PACMAN].fps = 12.0f;
+    sp->anims[SPRITE_ANIM_GHOST].first_layer = SPRITE_FACINGS * PACMAN_FRAMES;
+    sp->anims[SPRITE_ANIM_GHOST].frames = GHOST_FRAMES;
+    sp->anims[SPRITE_ANIM_GHOST].fps = 6.0f;
+    sp->layers = SPRITE_FACINGS * (PACMAN_FRAMES + GHOST_FRAMES);
+
+    size_t layer_bytes = (size_t)SPRITE_SIZE * SPRITE_SIZE * 4;
+    unsigned char *texels = (unsigned char*)calloc((size_t)sp->layers, layer_bytes);
+    if (!texels) return 0;
+    for (int f = 0; f < SPRITE_FACINGS; ++f) {
+        for (int k = 0; k < PACMAN_FRAMES; ++k)
+            draw_pacman(texels + layer_bytes * (size_t)anim_layer(&sp->anims[SPRITE_ANIM_PACMAN], f, k),
+                        f, pacman_mouth[k]);
+        for (int k = 0; k < GHOST_FRAMES; ++k)
+            draw_ghost(texels + layer_bytes * (size_t)anim_layer(&sp->anims[SPRITE_ANIM_GHOST], f, k), f, k);
+    }
+
+    glGenTextures(1, &sp->tex);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, sp->tex);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, SPRITE_SIZE, SPRITE_SIZE, sp->layers, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, texels);
+    /* nearest keeps the tinted / fixed / cut-out alpha classes apart */
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    free(texels);
+    return sp->tex != 0;
+}
+
+int sprites_init(Sprites *sp, GLuint program, GLuint quad_vbo, GLuint quad_ebo, int capacity)
+{
+    memset(sp, 0, sizeof(*sp));
+    if (!program || capacity <= 0) return 0;
+    sp->program = program;
+    sp->loc_uCamera = glGetUniformLocation(program, "uCamera");
+    sp->loc_uSprites = glGetUniformLocation(program, "uSprites");
+    if (!build_sheet(sp)) {
+        fprintf(stderr, "sprites: sheet setup failed\n");
+        return 0;
+    }
+
+    glGenVertexArrays(1, &sp->vao);
+    glGenBuffers(1, &sp->vbo);
+    if (!sp->vao || !sp->vbo) return 0;
+    glBindVertexArray(sp->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, sp->vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * capacity, NULL, GL_DYNAMIC_DRAW);
+    sp->capacity = capacity;
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ebo);
+    glBindVertexArray(0);
+    return 1;
+}
+
+void sprites_shutdown(Sprites *sp)
+{
+    if (sp->vao) glDeleteVertexArrays(1, &sp->vao);
+    if (sp->vbo) glDeleteBuffers(1, &sp->vbo);
+    if (sp->tex) glDeleteTextures(1, &sp->tex);
+    memset(sp, 0, sizeof(*sp));
+}
+
+int sprites_layer(const Sprites *sp, int anim, int facing, float time)
+{
+    const SpriteAnim *a = &sp->anims[anim];
+    int frame = (int)floorf(time * a->fps) % a->frames;
+    if (frame < 0) frame += a->frames;
+    return anim_layer(a, facing, frame);
+}
+
+void sprites_draw(Sprites *sp, int n, float cam_x, float cam_y, float view_hx, float view_hy)
+{
+    if (n > sp->capacity) n = sp->capacity;
+    if (n <= 0 || !sp->vao) return;
+
+    glUseProgram(sp->program);
+    glUniform4f(sp->loc_uCamera, cam_x, cam_y, 1.0f / view_hx, 1.0f / view_hy);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, sp->tex);
+    glUniform1i(sp->loc_uSprites, 0);
+    glBindVertexArray(sp->vao);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, n);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,116 @@
+// src/stream.c
+#include "stream.h"
+#include <stdio.h>
+
+#define STREAM_ALIGN 16
+
+int stream_init(StreamBuffer *s, GLsizeiptr segment_size)
+{
+    if (!s || segment_size <= 0) return 0;
+    s->segment_size = (segment_size + STREAM_ALIGN - 1) & ~(GLsizeiptr)(STREAM_ALIGN - 1);
+    s->base = NULL;
+    s->segment = STREAM_SEGMENTS - 1;
+    s->used = 0;
+    s->stats.frames = 0;
+    s->stats.fence_waits = 0;
+    s->stats.overflows = 0;
+    for (int i = 0; i < STREAM_SEGMENTS; ++i) s->fences[i] = 0;
+
+    glGenBuffers(1, &s->buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, s->buffer);
+
+    s->persistent = GLAD_GL_ARB_buffer_storage && glBufferStorage != NULL;
+    if (s->persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr total = s->segment_size * STREAM_SEGMENTS;
+        glBufferStorage(GL_ARRAY_BUFFER, total, NULL, flags);
+        s->base = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags);
+        if (!s->base) {
+            /* storage is immutable now, so start over with a plain buffer */
+            fprintf(stderr, "stream_init: persistent map failed, falling back to orphaning\n");
+            glDeleteBuffers(1, &s->buffer);
+            glGenBuffers(1, &s->buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, s->buffer);
+            s->persistent = 0;
+        }
+    }
+    if (!s->persistent) {
+        glBufferData(GL_ARRAY_BUFFER, s->segment_size, NULL, GL_STREAM_DRAW);
+    }
+    return 1;
+}
+
+void stream_shutdown(StreamBuffer *s)
+{
+    if (!s || !s->buffer) return;
+    for (int i = 0; i < STREAM_SEGMENTS; ++i) {
+        if (s->fences[i]) { glDeleteSync(s->fences[i]); s->fences[i] = 0; }
+    }
+    if (s->base) {
+        glBindBuffer(GL_ARRAY_BUFFER, s->buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        s->base = NULL;
+    }
+    glDeleteBuffers(1, &s->buffer);
+    s->buffer = 0;
+}
+
+int stream_begin(StreamBuffer *s)
+{
+    s->stats.frames++;
+    s->used = 0;
+
+    if (!s->persistent) {
+        /* orphan: the driver hands us fresh storage while the GPU keeps the old one */
+        glBindBuffer(GL_ARRAY_BUFFER, s->buffer);
+        glBufferData(GL_ARRAY_BUFFER, s->segment_size, NULL, GL_STREAM_DRAW);
+        s->base = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, s->segment_size,
+                                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        return s->base != NULL;
+    }
+
+    /* fence everything issued since the previous begin: that covers the draws
+       that read the segment we are leaving */
+    if (s->fences[s->segment]) glDeleteSync(s->fences[s->segment]);
+    s->fences[s->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    s->segment = (s->segment + 1) % STREAM_SEGMENTS;
+    GLsync fence = s->fences[s->segment];
+    if (fence) {
+        GLenum r = glClientWaitSync(fence, 0, 0);
+        if (r == GL_TIMEOUT_EXPIRED) {
+            s->stats.fence_waits++;
+            do {
+                r = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); /* 1 ms */
+            } while (r == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        s->fences[s->segment] = 0;
+        if (r == GL_WAIT_FAILED) return 0;
+    }
+    return 1;
+}
+
+void *stream_alloc(StreamBuffer *s, GLsizeiptr size, GLintptr *offset)
+{
+    GLsizeiptr start = (s->used + STREAM_ALIGN - 1) & ~(GLsizeiptr)(STREAM_ALIGN - 1);
+    if (!s->base || size <= 0 || start + size > s->segment_size) {
+        s->stats.overflows++;
+        return NULL;
+    }
+    s->used = start + size;
+
+    GLintptr seg_start = s->persistent ? (GLintptr)s->segment * s->segment_size : 0;
+    *offset = seg_start + start;
+    return s->base + seg_start + start;
+}
+
+void stream_commit(StreamBuffer *s)
+{
+    /* persistent + coherent maps need no flush; the orphaned map must be
+       released before any draw sources from it */
+    if (s->persistent || !s->base) return;
+    glBindBuffer(GL_ARRAY_BUFFER, s->buffer);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    s->base = NULL;
+}
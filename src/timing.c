@@ -0,0 +1,159 @@
+// src/timing.c
+#include "timing.h"
+#include <string.h>
+
+#define FRAME_NONE (~0ULL)
+
+int gpu_timers_init(GpuTimers *t)
+{
+    memset(t, 0, sizeof(*t));
+    t->active = -1;
+    glGenQueries(GPU_TIMER_FRAMES * GPU_PASS_COUNT, &t->queries[0][0]);
+    return t->queries[0][0] != 0;
+}
+
+void gpu_timers_shutdown(GpuTimers *t)
+{
+    if (t->queries[0][0]) glDeleteQueries(GPU_TIMER_FRAMES * GPU_PASS_COUNT, &t->queries[0][0]);
+    memset(t, 0, sizeof(*t));
+    t->active = -1;
+}
+
+void gpu_timers_begin_frame(GpuTimers *t)
+{
+    if (t->active >= 0) gpu_timer_end(t);
+    if (t->started) t->frame++;
+    t->started = 1;
+
+    t->set = (int)(t->frame % GPU_TIMER_FRAMES);
+    if (t->pending[t->set]) t->missed++;   /* nobody collected it in time */
+    t->pending[t->set] = 0;
+    t->frame_of[t->set] = t->frame;
+    memset(t->issued[t->set], 0, sizeof(t->issued[t->set]));
+}
+
+void gpu_timer_begin(GpuTimers *t, GpuPass pass)
+{
+    if (!t->started || !t->queries[0][0]) return;
+    if (t->active >= 0) gpu_timer_end(t);   /* GL_TIME_ELAPSED queries cannot nest */
+    glBeginQuery(GL_TIME_ELAPSED, t->queries[t->set][pass]);
+    t->issued[t->set][pass] = 1;
+    t->pending[t->set] = 1;
+    t->active = pass;
+}
+
+void gpu_timer_end(GpuTimers *t)
+{
+    if (t->active < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    t->active = -1;
+}
+
+void gpu_timers_collect(GpuTimers *t, FrameTimeRing *ring)
+{
+    for (int s = 0; s < GPU_TIMER_FRAMES; ++s) {
+        /* the current set is still being recorded */
+        if (!t->pending[s] || (s == t->set && t->active >= 0)) continue;
+
+        /* results become available in order, so the last issued pass decides */
+        int last = -1;
+        for (int p = 0; p < GPU_PASS_COUNT; ++p) if (t->issued[s][p]) last = p;
+        GLuint ready = 0;
+        glGetQueryObjectuiv(t->queries[s][last], GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (!ready) continue;
+
+        FrameTime *f = &ring->entries[t->frame_of[s] % FRAME_TIME_HISTORY];
+        int filed = f->frame == t->frame_of[s];
+        for (int p = 0; p < GPU_PASS_COUNT; ++p) {
+            GLuint64 ns = 0;
+            if (t->issued[s][p]) glGetQueryObjectui64v(t->queries[s][p], GL_QUERY_RESULT, &ns);
+            if (filed) f->gpu_ms[p] = (float)(ns * 1e-6);
+        }
+        if (filed) f->gpu_valid = 1;
+        t->pending[s] = 0;
+    }
+}
+
+void frame_times_init(FrameTimeRing *r)
+{
+    memset(r, 0, sizeof(*r));
+    for (int i = 0; i < FRAME_TIME_HISTORY; ++i) r->entries[i].frame = FRAME_NONE;
+}
+
+void frame_times_push(FrameTimeRing *r, unsigned long long frame, float update_ms, float render_ms)
+{
+    FrameTime *f = &r->entries[frame % FRAME_TIME_HISTORY];
+    memset(f, 0, sizeof(*f));
+    f->frame = frame;
+    f->update_ms = update_ms;
+    f->render_ms = render_ms;
+    r->newest = frame;
+    r->count++;
+}
+
+void frame_times_set_latency(FrameTimeRing *r, unsigned long long frame, float latency_ms)
+{
+    FrameTime *f = &r->entries[frame % FRAME_TIME_HISTORY];
+    if (f->frame == frame) f->latency_ms = latency_ms;
+}
+
+static float gpu_total(const FrameTime *f)
+{
+    float sum = 0.0f;
+    for (int p = 0; p < GPU_PASS_COUNT; ++p) sum += f->gpu_ms[p];
+    return sum;
+}
+
+FrameBound frame_time_bound(const FrameTime *f)
+{
+    if (!f->gpu_valid) return FRAME_BOUND_UNKNOWN;
+    float gpu = gpu_total(f);
+    if (f->update_ms >= f->render_ms && f->update_ms >= gpu) return FRAME_BOUND_SIM;
+    return gpu > f->render_ms ? FRAME_BOUND_GPU : FRAME_BOUND_DRIVER;
+}
+
+const char *frame_bound_name(FrameBound b)
+{
+    switch (b) {
+    case FRAME_BOUND_SIM:    return "sim-bound";
+    case FRAME_BOUND_DRIVER: return "driver-bound";
+    case FRAME_BOUND_GPU:    return "gpu-bound";
+    default:                 return "unknown";
+    }
+}
+
+void frame_times_summary(const FrameTimeRing *r, int n, FrameTimeSummary *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (n > FRAME_TIME_HISTORY) n = FRAME_TIME_HISTORY;
+
+    int gpu_frames = 0, presented = 0;
+    for (int i = 0; i < n && (unsigned long long)i < r->count; ++i) {
+        unsigned long long frame = r->newest - i;
+        const FrameTime *f = &r->entries[frame % FRAME_TIME_HISTORY];
+        if (f->frame != frame) break;   /* ids skipped or ran past the start */
+
+        out->frames++;
+        out->update_ms += f->update_ms;
+        out->render_ms += f->render_ms;
+        float gpu = gpu_total(f);
+        if (f->gpu_valid) { out->gpu_ms += gpu; gpu_frames++; }
+        if (f->latency_ms > 0.0f) {
+            out->latency_ms += f->latency_ms;
+            if (f->latency_ms > out->latency_max_ms) out->latency_max_ms = f->latency_ms;
+            presented++;
+        }
+
+        float total = f->update_ms + (gpu > f->render_ms ? gpu : f->render_ms);
+        if (total > out->worst_ms) {
+            out->worst_ms = total;
+            out->worst_bound = frame_time_bound(f);
+        }
+    }
+    if (out->frames) {
+        out->update_ms /= out->frames;
+        out->render_ms /= out->frames;
+    }
+    if (gpu_frames) out->gpu_ms /= gpu_frames;
+    if (presented) out->latency_ms /= presented;
+}
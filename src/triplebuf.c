@@ -0,0 +1,37 @@
+// src/triplebuf.c
+#include "triplebuf.h"
+
+#define TRIPLE_FRESH 4
+#define TRIPLE_INDEX 3
+
+void triple_init(TripleBuffer *t)
+{
+    t->back = 0;
+    atomic_init(&t->middle, 1);
+    t->front = 2;
+}
+
+int triple_back(const TripleBuffer *t)
+{
+    return t->back;
+}
+
+void triple_publish(TripleBuffer *t)
+{
+    /* release: the slot's contents happen-before the reader's acquire */
+    int old = atomic_exchange_explicit(&t->middle, t->back | TRIPLE_FRESH, memory_order_acq_rel);
+    t->back = old & TRIPLE_INDEX;
+}
+
+int triple_acquire(TripleBuffer *t)
+{
+    if (!(atomic_load_explicit(&t->middle, memory_order_relaxed) & TRIPLE_FRESH)) return 0;
+    int old = atomic_exchange_explicit(&t->middle, t->front, memory_order_acq_rel);
+    t->front = old & TRIPLE_INDEX;
+    return 1;
+}
+
+int triple_front(const TripleBuffer *t)
+{
+    return t->front;
+}